@@ -4,3 +4,25 @@ PREBUILD_DESC =
 PREBUILD_COMMAND = 
 POSTBUILD_DESC = 
 POSTBUILD_COMMAND = 
+
+# The native scene is regenerated from main.edc whenever main.edc, its defines or the generator
+# change. The generator replaces src/scene_main.c only if its content changes, and its failure
+# fails the build rather than leaving a stale scene behind. If no Python 3 interpreter is found,
+# the checked-in src/scene_main.c is built as it is; 'make regen-scene' regenerates it explicitly.
+SCENE_PYTHON := $(shell command -v python3 2>/dev/null)
+SCENE_GENERATOR := $(PROJ_ROOT)/tools/edc2scene.py
+SCENE_EDC := $(PROJ_ROOT)/res/edje/main.edc
+SCENE_OUTPUT := $(PROJ_ROOT)/src/scene_main.c
+
+ifneq ($(SCENE_PYTHON),)
+$(SCENE_OUTPUT) : $(SCENE_EDC) $(PROJ_ROOT)/inc/view_defines.h $(SCENE_GENERATOR)
+	@echo Generating the native scene from main.edc
+	"$(SCENE_PYTHON)" "$(SCENE_GENERATOR)" "$(SCENE_EDC)" "$@"
+else
+$(warning python3 is not found, the native scene is not regenerated from main.edc)
+endif
+
+.PHONY : regen-scene
+regen-scene :
+	@test -n "$(SCENE_PYTHON)" || { echo "python3 is required to regenerate the native scene." >&2; exit 1; }
+	"$(SCENE_PYTHON)" "$(SCENE_GENERATOR)" "$(SCENE_EDC)" "$(SCENE_OUTPUT)"
@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_ASSET_STORE_H)
+#define _ASSET_STORE_H
+
+#include <Elementary.h>
+
+/*
+ * The decoded images are shared between the instances of the face (e.g. the watch face picker's
+ * preview and the live face) through the named shared memory segment. Set ASSET_STORE_ENABLED to 0
+ * to make each instance decode its images privately.
+ *
+ * Only the native scene (VIEW_NATIVE_SCENE) draws the images from the store. The EDJE layout loads
+ * its images from main.edj itself and switches them on its state changes, so the default build
+ * decodes them privately in each instance.
+ */
+#if !defined(ASSET_STORE_ENABLED)
+#define ASSET_STORE_ENABLED 1
+#endif
+
+/*
+ * Bump the version whenever the layout of the segment changes.
+ */
+#define ASSET_STORE_VERSION 1
+#define ASSET_STORE_MAX_ENTRIES 16
+#define ASSET_STORE_NAME_MAX 64
+
+bool asset_store_attach(Evas *evas, const char *res_path, const char **images, int count);
+void *asset_store_image_get(const char *image, int *w, int *h, bool *alpha);
+size_t asset_store_get_size(void);
+size_t asset_store_get_proportional_size(void);
+void asset_store_detach(void);
+
+#endif
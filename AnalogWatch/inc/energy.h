@@ -0,0 +1,64 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_ENERGY_H)
+#define _ENERGY_H
+
+#include <stdbool.h>
+
+typedef enum {
+	ENERGY_SOURCE_STARTUP,
+	ENERGY_SOURCE_TIME_TICK,
+	ENERGY_SOURCE_AMBIENT_TICK,
+	ENERGY_SOURCE_BADGE,
+	ENERGY_SOURCE_TOUCH,
+	ENERGY_SOURCE_SENSOR,
+	ENERGY_SOURCE_MAX
+} energy_source_t;
+
+/*
+ * The device model converts the work done by the watch face into the charge drawn from the battery.
+ * Each kind of work is expressed as the equivalent CPU time spent at cpu_active_ma.
+ */
+typedef struct {
+	double cpu_active_ma;
+	double wakeup_ms;
+	double message_us;
+	double pixel_ns;
+	double decode_ns_per_byte;
+} energy_device_model_t;
+
+/*
+ * The number of events of each source during the day.
+ */
+typedef struct {
+	double events[ENERGY_SOURCE_MAX];
+} energy_day_profile_t;
+
+void energy_set_device_model(const energy_device_model_t *model);
+void energy_begin(energy_source_t source);
+void energy_end(void);
+energy_source_t energy_get_source(void);
+void energy_account_busy(energy_source_t source, double seconds);
+double energy_get_wakeups(energy_source_t source);
+void energy_account_message(energy_source_t source);
+void energy_account_pixels(energy_source_t source, unsigned long long pixels);
+void energy_account_decoded(energy_source_t source, unsigned long long bytes);
+double energy_estimate_mah_per_day(const energy_day_profile_t *profile);
+void energy_get_standard_day_profile(energy_day_profile_t *profile);
+bool energy_check_budget(void);
+
+#endif
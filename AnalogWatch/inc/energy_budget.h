@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_ENERGY_BUDGET_H)
+#define _ENERGY_BUDGET_H
+
+#include "sensor_complication.h"
+
+/*
+ * The energy budget of the watch face checked by the ENERGY_BENCHMARK build.
+ * Raising the budget must be justified in the commit which does it.
+ */
+#define ENERGY_BUDGET_MAH_PER_DAY 2.0
+
+/*
+ * The default device model. The values are rough figures for a wearable SoC and should be replaced
+ * with the ones measured on the target device, or overridden with energy_set_device_model().
+ */
+#define ENERGY_MODEL_CPU_ACTIVE_MA 90.0
+#define ENERGY_MODEL_WAKEUP_MS 4.0
+#define ENERGY_MODEL_MESSAGE_US 150.0
+#define ENERGY_MODEL_PIXEL_NS 5.0
+#define ENERGY_MODEL_DECODE_NS_PER_BYTE 8.0
+
+/*
+ * The standard 24-hour usage profile: 2 hours of the active display, 22 hours of the ambient mode,
+ * 150 badge changes, 40 icon taps (a mouse down and a mouse up each) and, if the sensor complication
+ * is built, the sensor FIFO flushed every 10 s in the active mode and every 60 s in the ambient mode.
+ */
+#define ENERGY_PROFILE_STARTUPS 1.0
+#define ENERGY_PROFILE_TIME_TICKS (2.0 * 3600.0)
+#define ENERGY_PROFILE_AMBIENT_TICKS (22.0 * 60.0)
+#define ENERGY_PROFILE_BADGES 150.0
+#define ENERGY_PROFILE_TOUCHES (2.0 * 40.0)
+#if SENSOR_COMPLICATION_ENABLED
+#define ENERGY_PROFILE_ACTIVE_SENSOR_BATCHES (2.0 * 360.0)
+#define ENERGY_PROFILE_AMBIENT_SENSOR_BATCHES (22.0 * 60.0)
+#else
+#define ENERGY_PROFILE_ACTIVE_SENSOR_BATCHES 0.0
+#define ENERGY_PROFILE_AMBIENT_SENSOR_BATCHES 0.0
+#endif
+#define ENERGY_PROFILE_SENSOR_BATCHES (ENERGY_PROFILE_ACTIVE_SENSOR_BATCHES + ENERGY_PROFILE_AMBIENT_SENSOR_BATCHES)
+
+#endif
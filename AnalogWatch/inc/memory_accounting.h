@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_MEMORY_ACCOUNTING_H)
+#define _MEMORY_ACCOUNTING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum {
+	MEMORY_SUBSYSTEM_VIEW,
+	MEMORY_SUBSYSTEM_LAYOUT,
+	MEMORY_SUBSYSTEM_IMAGES,
+	MEMORY_SUBSYSTEM_TEXT,
+	MEMORY_SUBSYSTEM_BADGES,
+	MEMORY_SUBSYSTEM_SENSORS,
+	MEMORY_SUBSYSTEM_MAX
+} memory_subsystem_t;
+
+typedef void (*memory_evict_cb)(void *data);
+
+void memory_set_budget(size_t budget);
+bool memory_reserve(memory_subsystem_t subsystem, size_t size);
+bool memory_reserve_optional(memory_subsystem_t subsystem, size_t size);
+void memory_release(memory_subsystem_t subsystem, size_t size);
+bool memory_set_usage(memory_subsystem_t subsystem, size_t size);
+void memory_set_evict_cb(memory_subsystem_t subsystem, memory_evict_cb cb, void *data);
+void *memory_malloc(memory_subsystem_t subsystem, size_t size);
+void *memory_calloc(memory_subsystem_t subsystem, size_t count, size_t size);
+void memory_free(void *ptr);
+size_t memory_get_current(memory_subsystem_t subsystem);
+size_t memory_get_peak(memory_subsystem_t subsystem);
+size_t memory_get_total_current(void);
+size_t memory_get_total_peak(void);
+size_t memory_get_peak_rss(void);
+size_t memory_get_rss(void);
+size_t memory_get_pss(void);
+void memory_report(void);
+
+#endif
@@ -0,0 +1,41 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_MEMORY_BUDGET_H)
+#define _MEMORY_BUDGET_H
+
+/*
+ * The total size of the memory accounted by the subsystems of the watch face.
+ * Optional assets are refused or evicted rather than exceeding it. The MEMORY_BENCHMARK build
+ * checks the growth of the peak resident set size since the face's creation against it as well,
+ * so the memory not accounted by the subsystems (e.g. the allocations of the libraries on behalf
+ * of the face) is caught too. tools/run_benchmark.sh runs that build and checks its verdict unattended.
+ */
+#define MEMORY_BUDGET_BYTES (4 * 1024 * 1024)
+
+/*
+ * The caps of the canvas caches. Unused decoded images and glyphs beyond the caps are dropped.
+ */
+#define MEMORY_IMAGE_CACHE_BYTES (512 * 1024)
+#define MEMORY_FONT_CACHE_BYTES (256 * 1024)
+
+/*
+ * The size of a rasterised glyph: the 8-bit coverage mask of about the font size squared and its
+ * cache entry. The text is accounted as the glyphs of the distinct characters displayed at each font size.
+ */
+#define MEMORY_GLYPH_BYTES(font_size) ((size_t)(font_size) * (font_size) + 64)
+
+#endif
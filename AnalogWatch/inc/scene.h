@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_SCENE_H)
+#define _SCENE_H
+
+#include <Elementary.h>
+
+/*
+ * The native scene description is generated from res/edje/main.edc by tools/edc2scene.py
+ * into src/scene_main.c. Do not edit the generated file, change main.edc instead.
+ */
+
+typedef enum {SCENE_PART_IMAGE, SCENE_PART_RECT, SCENE_PART_TEXTBLOCK} scene_part_type_t;
+
+typedef struct {
+	const char *name;
+	scene_part_type_t type;
+	int x;
+	int y;
+	int w;
+	int h;
+	const char *image;
+	const char *pressed_image;
+	int color[4];
+	const char *text_style;
+	bool visible;
+	bool mouse_events;
+	bool repeat_events;
+	bool map_rotation;
+	int center_x;
+	int center_y;
+} scene_part_t;
+
+/*
+ * A numeric value of the frame state displayed by the text part. The value is hidden if it
+ * is not positive. The badge part, if any (>= 0), is shown along with the text part. Values
+ * greater than max_value, if set, are displayed as "<max_value>+".
+ */
+typedef struct {
+	int badge_part;
+	int text_part;
+	int frame_state_idx;
+	int dirty_flag;
+	int max_value;
+} scene_counter_t;
+
+typedef struct {
+	int width;
+	int height;
+	const scene_part_t *parts;
+	int part_count;
+	const scene_counter_t *counters;
+	int counter_count;
+} scene_t;
+
+extern const scene_t scene_main[];
+extern const int scene_main_count;
+
+const scene_t *scene_find(const scene_t *scenes, int count, int width, int height);
+bool scene_create(Evas_Object *win, const scene_t *scene);
+void scene_apply_frame_state(const int *values, int dirty);
+Evas_Object *scene_part_object_get(const char *part_name);
+bool scene_part_is_shared(const char *part_name);
+void scene_destroy(void);
+
+#endif
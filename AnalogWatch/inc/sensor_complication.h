@@ -0,0 +1,53 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(_SENSOR_COMPLICATION_H)
+#define _SENSOR_COMPLICATION_H
+
+#include <stdbool.h>
+
+/*
+ * Set to 0 to build the watch face without the steps and heart rate complication,
+ * e.g. in order to compare the number of wakeups per hour.
+ */
+#if !defined(SENSOR_COMPLICATION_ENABLED)
+#define SENSOR_COMPLICATION_ENABLED 1
+#endif
+
+/*
+ * The pedometer sensor is available since Tizen 3.0. The project's wearable-2.3.1 profile does not
+ * provide it, so by default the steps are detected in the batched accelerometer readings. Set to 1
+ * when building for a newer profile in order to read them from the pedometer.
+ */
+#if !defined(SENSOR_PEDOMETER_SUPPORTED)
+#define SENSOR_PEDOMETER_SUPPORTED 0
+#endif
+
+/*
+ * Set to 0 to deliver every reading as soon as it is sampled instead of collecting the readings
+ * in the sensor FIFO, e.g. in order to compare the number of wakeups per hour.
+ */
+#if !defined(SENSOR_BATCHING_ENABLED)
+#define SENSOR_BATCHING_ENABLED 1
+#endif
+
+bool sensor_complication_create(void);
+void sensor_complication_set_ambient_mode(bool ambient_mode);
+void sensor_complication_tick(void);
+void sensor_complication_flush(void);
+void sensor_complication_destroy(void);
+
+#endif
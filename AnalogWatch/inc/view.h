@@ -21,18 +21,21 @@
 #include <efl_extension.h>
 #include "analogwatch.h"
 
-typedef enum {VIEW_ICON_ID_MISSED_CALLS, VIEW_ICON_ID_UNREAD_MESSAGES} view_icon_id_t;
+typedef enum {VIEW_ICON_ID_MISSED_CALLS, VIEW_ICON_ID_UNREAD_MESSAGES, VIEW_ICON_ID_MAX} view_icon_id_t;
 typedef void (*icon_pressed_cb)(view_icon_id_t id);
 
-void view_create_with_size(int width, int height);
-void view_create(void);
+bool view_create_with_size(int width, int height);
+bool view_create(void);
 Evas_Object *view_create_win(const char *pkg_name);
 Evas_Object *view_create_layout_for_part(Evas_Object *parent, char *file_path, char *group_name, char *part_name);
 void view_set_display_time(current_time_t current_time);
 void view_toggle_ambient_mode(bool ambient_mode);
 void view_set_bagde_missed_calls(int count);
 void view_set_bagde_unread_messages(int count);
+void view_set_steps(int count);
+void view_set_heart_rate(int bpm);
 void view_set_icon_pressed_cb(icon_pressed_cb cb);
+void view_feed_icon_event(view_icon_id_t id, bool pressed);
 void view_destroy(void);
 
 #endif
@@ -17,20 +17,47 @@
 #if !defined(_VIEW_DEFINES_H)
 #define _VIEW_DEFINES_H
 
+#define PART_BACKGROUND "background"
+#define PART_HANDS_CENTER "hands_center"
+#define PART_HAND_HOUR "hand_hour"
+#define PART_HAND_MINUTE "hand_minute"
 #define PART_MISSED_CALLS "missed_calls"
 #define PART_MISSED_CALLS_BADGE "missed_calls_badge"
 #define PART_UNREAD_MESSAGES "unread_messages"
 #define PART_UNREAD_MESSAGES_BADGE "unread_messages_badge"
 #define PART_HAND_SECOND "hand_second"
+#define PART_STEPS "steps"
+#define PART_HEART_RATE "heart_rate"
 
-#define SIGNAL_MISSED_CALLS_PRESS "signal_missed_calls_press"
-#define SIGNAL_MISSED_CALLS_UNPRESS "signal_missed_calls_unpress"
-#define SIGNAL_UNREAD_MESSAGES_PRESS "signal_unread_messages_press"
-#define SIGNAL_UNREAD_MESSAGES_UNPRESS "signal_unread_messages_unpress"
+#define MSG_ID_SET_FRAME_STATE 1
 
-#define MSG_ID_SET_TIME 1
-#define MSG_ID_AMBIENT_MODE 2
-#define MSG_ID_SET_BADGE_MISSED_CALLS 3
-#define MSG_ID_SET_BADGE_UNREAD_MESSAGES 4
+/*
+ * The frame state is sent to the EDJE script as a single MSG_INT_SET message.
+ * The values below are the indices of the fields within the message. The script
+ * ignores the message if the version field does not match FRAME_STATE_VERSION.
+ */
+#define FRAME_STATE_VERSION 2
+
+#define FRAME_STATE_IDX_VERSION 0
+#define FRAME_STATE_IDX_DIRTY 1
+#define FRAME_STATE_IDX_HOUR 2
+#define FRAME_STATE_IDX_MINUTE 3
+#define FRAME_STATE_IDX_SECOND 4
+#define FRAME_STATE_IDX_AMBIENT_MODE 5
+#define FRAME_STATE_IDX_MISSED_CALLS 6
+#define FRAME_STATE_IDX_UNREAD_MESSAGES 7
+#define FRAME_STATE_IDX_STEPS 8
+#define FRAME_STATE_IDX_HEART_RATE 9
+#define FRAME_STATE_COUNT 10
+
+/*
+ * Bits of the FRAME_STATE_IDX_DIRTY field. Only the fields marked as dirty are applied by the script.
+ */
+#define FRAME_STATE_DIRTY_TIME 1
+#define FRAME_STATE_DIRTY_AMBIENT_MODE 2
+#define FRAME_STATE_DIRTY_MISSED_CALLS 4
+#define FRAME_STATE_DIRTY_UNREAD_MESSAGES 8
+#define FRAME_STATE_DIRTY_STEPS 16
+#define FRAME_STATE_DIRTY_HEART_RATE 32
 
 #endif
@@ -0,0 +1,491 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "analogwatch.h"
+#include "asset_store.h"
+
+#define ASSET_STORE_SHM_NAME "/" PACKAGE ".assets"
+#define ASSET_STORE_LOCK_NAME "/" PACKAGE ".assets.lock"
+#define ASSET_STORE_MAGIC 0x54535341 /* "ASST" */
+#define ASSET_STORE_ALIGN 16
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+	char name[ASSET_STORE_NAME_MAX];
+	int w;
+	int h;
+	bool alpha;
+	size_t offset;
+	size_t size;
+} asset_entry_t;
+
+/*
+ * The segment starts with the header followed by the page aligned data area holding the
+ * premultiplied ARGB8888 pixels of each entry. The header is mapped for writing, as it holds
+ * the reference counter, while every instance maps the data area copy-on-write: the canvas is
+ * handed the pixels as the image's own buffer, so a write through it (e.g. by the engine) would
+ * fault on a read-only mapping. A private copy of the written pages is made instead, so the
+ * segment is never modified and the pages which are only read stay shared.
+ *
+ * Whether the store is in use is decided by the kernel rather than by the reference counter:
+ * each attached instance holds a shared flock() on the segment, which is released even if the
+ * instance is killed. The reference counter only tells the number of the instances sharing the
+ * images and is reset once the store has no users, dropping the references of the killed instances.
+ */
+typedef struct {
+	unsigned int magic;
+	unsigned int version;
+	unsigned int stamp;
+	int refcount;
+	int entry_count;
+	size_t data_offset;
+	size_t data_size;
+	asset_entry_t entries[ASSET_STORE_MAX_ENTRIES];
+} asset_store_header_t;
+
+static struct asset_store_info {
+	int fd;
+	asset_store_header_t *header;
+	size_t header_size;
+	unsigned char *data;
+	size_t data_size;
+} s_info = {
+	.fd = -1,
+	.header = NULL,
+	.header_size = 0,
+	.data = NULL,
+	.data_size = 0,
+};
+
+static unsigned int _compute_stamp(const char *res_path, const char **images, int count);
+static int _lock(void);
+static void _unlock(int lock_fd);
+static bool _map_header(size_t size);
+static bool _publish(Evas *evas, const char *res_path, const char **images, int count, unsigned int stamp);
+static void _unmap(void);
+
+/*
+ * @brief Attaches to the shared store of the decoded images. The first instance decodes the images
+ * and publishes them, the following instances map the published images. The store is republished
+ * if the images have changed, unless it is still used by another instance.
+ * @param[evas]: the canvas used to decode the images.
+ * @param[res_path]: the application's resource directory.
+ * @param[images]: the paths of the images relative to the resource directory.
+ * @param[count]: the number of the images.
+ * @return: The function returns 'true' if the store is attached, otherwise 'false' is returned.
+ */
+bool asset_store_attach(Evas *evas, const char *res_path, const char **images, int count)
+{
+	unsigned int stamp;
+	struct stat st;
+	bool valid = false;
+	bool alone = false;
+	int lock_fd;
+	void *data = NULL;
+
+	if (!evas || !res_path || !images || count <= 0 || count > ASSET_STORE_MAX_ENTRIES) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+		return false;
+	}
+
+	if (s_info.fd >= 0)
+		return true;
+
+	stamp = _compute_stamp(res_path, images, count);
+
+	lock_fd = _lock();
+	if (lock_fd < 0)
+		return false;
+
+	s_info.fd = shm_open(ASSET_STORE_SHM_NAME, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+	if (s_info.fd < 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "shm_open() is failed.");
+		goto error;
+	}
+
+	if (fstat(s_info.fd, &st) == 0 && (size_t)st.st_size >= sizeof(asset_store_header_t) && _map_header(sizeof(asset_store_header_t))) {
+		size_t header_size = s_info.header->data_offset;
+
+		valid = s_info.header->magic == ASSET_STORE_MAGIC && s_info.header->version == ASSET_STORE_VERSION &&
+				s_info.header->stamp == stamp;
+
+		munmap(s_info.header, s_info.header_size);
+		s_info.header = NULL;
+
+		if (valid && !_map_header(header_size))
+			goto error;
+	}
+
+	/*
+	 * The exclusive lock is granted only if no other instance holds the shared one.
+	 */
+	alone = flock(s_info.fd, LOCK_EX | LOCK_NB) == 0;
+
+	if (!valid) {
+		if (!alone) {
+			dlog_print(DLOG_WARN, LOG_TAG, "asset store is used by an instance with other assets.");
+			goto error;
+		}
+
+		if (!_publish(evas, res_path, images, count, stamp))
+			goto error;
+	} else if (alone) {
+		s_info.header->refcount = 0;
+	}
+
+	/*
+	 * Converting the exclusive lock into the shared one is not atomic, but the store lock
+	 * keeps the other instances out meanwhile.
+	 */
+	if (flock(s_info.fd, LOCK_SH) != 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "flock() is failed.");
+		goto error;
+	}
+
+	data = mmap(NULL, s_info.header->data_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, s_info.fd, (off_t)s_info.header->data_offset);
+	if (data == MAP_FAILED) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to map the asset store's data.");
+		goto error;
+	}
+
+	s_info.data = data;
+	s_info.data_size = s_info.header->data_size;
+	s_info.header->refcount++;
+
+	dlog_print(DLOG_INFO, LOG_TAG, "asset store: %s %d images, %zu B, %d instances",
+			valid ? "attached to" : "published", s_info.header->entry_count, s_info.data_size, s_info.header->refcount);
+
+	_unlock(lock_fd);
+
+	return true;
+
+error:
+	_unmap();
+	_unlock(lock_fd);
+
+	return false;
+}
+
+/*
+ * @brief Gets the decoded image from the store.
+ * @param[image]: the path of the image relative to the resource directory.
+ * @param[w]: the width of the image (optional).
+ * @param[h]: the height of the image (optional).
+ * @param[alpha]: whether the image has the alpha channel (optional).
+ * @return: The premultiplied ARGB8888 pixels or NULL if the image is not in the store. They are
+ * mapped copy-on-write, so writing them never changes the images of the other instances.
+ */
+void *asset_store_image_get(const char *image, int *w, int *h, bool *alpha)
+{
+	const asset_entry_t *entry = NULL;
+	int i;
+
+	if (!s_info.data || !image)
+		return NULL;
+
+	for (i = 0; i < s_info.header->entry_count; i++) {
+		entry = &s_info.header->entries[i];
+
+		if (strcmp(entry->name, image) != 0)
+			continue;
+
+		if (w)
+			*w = entry->w;
+
+		if (h)
+			*h = entry->h;
+
+		if (alpha)
+			*alpha = entry->alpha;
+
+		return s_info.data + entry->offset;
+	}
+
+	return NULL;
+}
+
+/*
+ * @brief Gets the size of the decoded images mapped from the store.
+ * @return: The size in bytes.
+ */
+size_t asset_store_get_size(void)
+{
+	return s_info.data_size;
+}
+
+/*
+ * @brief Gets the size of the decoded images divided by the number of the instances sharing them,
+ * i.e. the share of the store accounted to the proportional set size of this instance.
+ * @return: The size in bytes.
+ */
+size_t asset_store_get_proportional_size(void)
+{
+	if (!s_info.header || s_info.header->refcount <= 0)
+		return s_info.data_size;
+
+	return s_info.data_size / s_info.header->refcount;
+}
+
+/*
+ * @brief Detaches from the store. The segment is removed once the last instance has detached.
+ * The images must not be used afterwards.
+ */
+void asset_store_detach(void)
+{
+	int lock_fd;
+
+	if (s_info.fd < 0)
+		return;
+
+	lock_fd = _lock();
+	if (lock_fd >= 0) {
+		s_info.header->refcount--;
+
+		/*
+		 * The last instance is the only one which gets the exclusive lock.
+		 */
+		if (flock(s_info.fd, LOCK_EX | LOCK_NB) == 0)
+			shm_unlink(ASSET_STORE_SHM_NAME);
+	}
+
+	_unmap();
+	_unlock(lock_fd);
+}
+
+/*
+ * @brief Computes the stamp of the images' files, so that the store is republished when the images change.
+ * @param[res_path]: the application's resource directory.
+ * @param[images]: the paths of the images relative to the resource directory.
+ * @param[count]: the number of the images.
+ * @return: The FNV-1a hash of the images' paths, sizes and modification times.
+ */
+static unsigned int _compute_stamp(const char *res_path, const char **images, int count)
+{
+	char path[PATH_MAX] = {0,};
+	unsigned int hash = FNV_OFFSET_BASIS;
+	struct stat st;
+	long long values[2];
+	const unsigned char *p = NULL;
+	size_t i;
+	int n;
+
+	for (n = 0; n < count; n++) {
+		snprintf(path, sizeof(path), "%s%s", res_path, images[n]);
+
+		memset(&st, 0, sizeof(st));
+		stat(path, &st);
+
+		values[0] = (long long)st.st_size;
+		values[1] = (long long)st.st_mtime;
+
+		for (p = (const unsigned char *)images[n]; *p; p++)
+			hash = (hash ^ *p) * FNV_PRIME;
+
+		for (i = 0, p = (const unsigned char *)values; i < sizeof(values); i++)
+			hash = (hash ^ p[i]) * FNV_PRIME;
+	}
+
+	return hash;
+}
+
+/*
+ * @brief Acquires the store lock which serializes the publishing, the attaching and the detaching
+ * of all the instances. The lock is released by the kernel if the instance is killed.
+ * @return: The descriptor holding the lock or -1 if the lock cannot be acquired.
+ */
+static int _lock(void)
+{
+	int lock_fd = shm_open(ASSET_STORE_LOCK_NAME, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+
+	if (lock_fd < 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "shm_open() is failed.");
+		return -1;
+	}
+
+	if (flock(lock_fd, LOCK_EX) != 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "flock() is failed.");
+		close(lock_fd);
+		return -1;
+	}
+
+	return lock_fd;
+}
+
+/*
+ * @brief Releases the store lock.
+ * @param[lock_fd]: the descriptor returned by _lock().
+ */
+static void _unlock(int lock_fd)
+{
+	if (lock_fd >= 0)
+		close(lock_fd);
+}
+
+/*
+ * @brief Maps the beginning of the segment, holding the header, for reading and writing.
+ * @param[size]: the size of the mapping.
+ * @return: The function returns 'true' if the header is mapped, otherwise 'false' is returned.
+ */
+static bool _map_header(size_t size)
+{
+	void *header = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, s_info.fd, 0);
+
+	if (header == MAP_FAILED) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to map the asset store's header.");
+		return false;
+	}
+
+	s_info.header = header;
+	s_info.header_size = size;
+
+	return true;
+}
+
+/*
+ * @brief Decodes the images and publishes them in the store. Must be called with the store lock
+ * and the exclusive lock on the segment held.
+ * @param[evas]: the canvas used to decode the images.
+ * @param[res_path]: the application's resource directory.
+ * @param[images]: the paths of the images relative to the resource directory.
+ * @param[count]: the number of the images.
+ * @param[stamp]: the stamp of the images' files.
+ * @return: The function returns 'true' if the images are published, otherwise 'false' is returned.
+ */
+static bool _publish(Evas *evas, const char *res_path, const char **images, int count, unsigned int stamp)
+{
+	Evas_Object *objects[ASSET_STORE_MAX_ENTRIES] = {NULL,};
+	asset_entry_t entries[ASSET_STORE_MAX_ENTRIES];
+	char path[PATH_MAX] = {0,};
+	size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+	size_t data_offset = (sizeof(asset_store_header_t) + page_size - 1) / page_size * page_size;
+	size_t data_size = 0;
+	unsigned char *data = NULL;
+	const unsigned char *pixels = NULL;
+	bool ret = false;
+	int stride;
+	int i, y;
+
+	memset(entries, 0, sizeof(entries));
+
+	for (i = 0; i < count; i++) {
+		snprintf(path, sizeof(path), "%s%s", res_path, images[i]);
+
+		objects[i] = evas_object_image_add(evas);
+		evas_object_image_file_set(objects[i], path, NULL);
+		if (evas_object_image_load_error_get(objects[i]) != EVAS_LOAD_ERROR_NONE) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to load '%s'.", path);
+			goto out;
+		}
+
+		snprintf(entries[i].name, sizeof(entries[i].name), "%s", images[i]);
+		evas_object_image_size_get(objects[i], &entries[i].w, &entries[i].h);
+		entries[i].alpha = evas_object_image_alpha_get(objects[i]);
+		entries[i].offset = data_size;
+		entries[i].size = (size_t)entries[i].w * entries[i].h * 4;
+
+		data_size += (entries[i].size + ASSET_STORE_ALIGN - 1) / ASSET_STORE_ALIGN * ASSET_STORE_ALIGN;
+	}
+
+	if (ftruncate(s_info.fd, 0) != 0 || ftruncate(s_info.fd, (off_t)(data_offset + data_size)) != 0) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to resize the asset store.");
+		goto out;
+	}
+
+	if (!_map_header(data_offset))
+		goto out;
+
+	data = mmap(NULL, data_size, PROT_READ | PROT_WRITE, MAP_SHARED, s_info.fd, (off_t)data_offset);
+	if (data == MAP_FAILED) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to map the asset store's data.");
+		goto out;
+	}
+
+	/*
+	 * The canvas keeps the decoded images premultiplied, so they are copied as they are, row by row,
+	 * as the canvas' rows may be padded.
+	 */
+	for (i = 0; i < count; i++) {
+		pixels = evas_object_image_data_get(objects[i], EINA_FALSE);
+		if (!pixels) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to get the pixels of '%s'.", images[i]);
+			munmap(data, data_size);
+			goto out;
+		}
+
+		stride = evas_object_image_stride_get(objects[i]);
+
+		for (y = 0; y < entries[i].h; y++)
+			memcpy(data + entries[i].offset + (size_t)y * entries[i].w * 4, pixels + (size_t)y * stride, (size_t)entries[i].w * 4);
+	}
+
+	munmap(data, data_size);
+
+	memcpy(s_info.header->entries, entries, sizeof(entries));
+	s_info.header->entry_count = count;
+	s_info.header->data_offset = data_offset;
+	s_info.header->data_size = data_size;
+	s_info.header->refcount = 0;
+	s_info.header->version = ASSET_STORE_VERSION;
+	s_info.header->stamp = stamp;
+
+	/*
+	 * The magic is written last, so the partially published store is never considered valid.
+	 */
+	s_info.header->magic = ASSET_STORE_MAGIC;
+
+	ret = true;
+
+out:
+	for (i = 0; i < count; i++)
+		if (objects[i])
+			evas_object_del(objects[i]);
+
+	/*
+	 * Drops the private copies of the decoded images, as they are used from the store from now on.
+	 */
+	evas_image_cache_flush(evas);
+
+	return ret;
+}
+
+/*
+ * @brief Unmaps the segment and closes its descriptor.
+ */
+static void _unmap(void)
+{
+	if (s_info.data)
+		munmap(s_info.data, s_info.data_size);
+
+	if (s_info.header)
+		munmap(s_info.header, s_info.header_size);
+
+	if (s_info.fd >= 0)
+		close(s_info.fd);
+
+	s_info.fd = -1;
+	s_info.header = NULL;
+	s_info.header_size = 0;
+	s_info.data = NULL;
+	s_info.data_size = 0;
+}
@@ -0,0 +1,330 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Elementary.h>
+#include "analogwatch.h"
+#include "energy.h"
+#include "energy_budget.h"
+
+#define ENERGY_REPORT_PERIOD 3600.0
+
+struct _energy_counters {
+	double events;
+	double wakeups;
+	double busy_time;
+	double messages;
+	double pixels;
+	double bytes_decoded;
+};
+
+static struct energy_info {
+	energy_device_model_t model;
+	struct _energy_counters counters[ENERGY_SOURCE_MAX];
+	energy_source_t source;
+	bool busy;
+	double begin_time;
+	double last_wakeup;
+	double report_start;
+} s_info = {
+	.model = {
+		.cpu_active_ma = ENERGY_MODEL_CPU_ACTIVE_MA,
+		.wakeup_ms = ENERGY_MODEL_WAKEUP_MS,
+		.message_us = ENERGY_MODEL_MESSAGE_US,
+		.pixel_ns = ENERGY_MODEL_PIXEL_NS,
+		.decode_ns_per_byte = ENERGY_MODEL_DECODE_NS_PER_BYTE,
+	},
+	.source = ENERGY_SOURCE_STARTUP,
+	.busy = false,
+	.begin_time = 0.0,
+	.last_wakeup = 0.0,
+	.report_start = 0.0,
+};
+
+/*
+ * The work done per event used by the periodic report for the sources which have not been observed yet.
+ * The budget check does not use them, see energy_check_budget().
+ */
+static const struct _energy_counters s_default_counters[ENERGY_SOURCE_MAX] = {
+	[ENERGY_SOURCE_STARTUP] = {1.0, 1.0, 0.150, 4.0, 360.0 * 360.0, 1200000.0},
+	[ENERGY_SOURCE_TIME_TICK] = {1.0, 1.0, 0.0005, 1.0, 40000.0, 0.0},
+	[ENERGY_SOURCE_AMBIENT_TICK] = {1.0, 1.0, 0.0005, 1.0, 60000.0, 0.0},
+	[ENERGY_SOURCE_BADGE] = {1.0, 1.0, 0.0003, 1.0, 5000.0, 0.0},
+	[ENERGY_SOURCE_TOUCH] = {1.0, 1.0, 0.0015, 0.0, 15000.0, 15000.0},
+	[ENERGY_SOURCE_SENSOR] = {1.0, 1.0, 0.0002, 0.0, 0.0, 0.0},
+};
+
+static const char *s_source_names[ENERGY_SOURCE_MAX] = {
+	[ENERGY_SOURCE_STARTUP] = "startup",
+	[ENERGY_SOURCE_TIME_TICK] = "time tick",
+	[ENERGY_SOURCE_AMBIENT_TICK] = "ambient tick",
+	[ENERGY_SOURCE_BADGE] = "badge",
+	[ENERGY_SOURCE_TOUCH] = "touch",
+	[ENERGY_SOURCE_SENSOR] = "sensor",
+};
+
+static double _event_mah(energy_source_t source);
+static void _report(void);
+
+/*
+ * @brief Replaces the default device model.
+ * @param[model]: the device model to be used for the estimates.
+ */
+void energy_set_device_model(const energy_device_model_t *model)
+{
+	if (!model) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+		return;
+	}
+
+	s_info.model = *model;
+}
+
+/*
+ * @brief Marks the beginning of the event's handler. The handler's time is attributed to the given
+ * source until energy_end() is called. The deferred work caused by the event (the frame state flush
+ * and the rendering) is attributed to it with energy_account_busy(), see energy_get_source().
+ * Callbacks invoked within one main loop iteration are counted as a single wakeup, and callbacks
+ * of the same source within one iteration (e.g. a batch of sensor readings) as a single event.
+ * This is the only wakeup counter of the application, see energy_get_wakeups().
+ * @param[source]: the source of the event.
+ */
+void energy_begin(energy_source_t source)
+{
+	double loop_time = ecore_loop_time_get();
+
+	if (s_info.busy)
+		energy_end();
+
+	if (loop_time != s_info.last_wakeup) {
+		s_info.last_wakeup = loop_time;
+		s_info.counters[source].wakeups++;
+		s_info.counters[source].events++;
+	} else if (source != s_info.source) {
+		s_info.counters[source].events++;
+	}
+
+	s_info.source = source;
+	s_info.busy = true;
+	s_info.begin_time = ecore_time_get();
+}
+
+/*
+ * @brief Marks the end of the event's handler started with energy_begin().
+ */
+void energy_end(void)
+{
+	if (!s_info.busy)
+		return;
+
+	energy_account_busy(s_info.source, ecore_time_get() - s_info.begin_time);
+	s_info.busy = false;
+
+	_report();
+}
+
+/*
+ * @brief Gets the source of the event being handled or, outside of the handlers, of the last event.
+ * The caller keeps it as the token of the deferred work caused by the event, so the work is attributed
+ * to the event even if it is done in a later main loop iteration.
+ * @return: The source of the current event.
+ */
+energy_source_t energy_get_source(void)
+{
+	return s_info.source;
+}
+
+/*
+ * @brief Adds the time spent on the work caused by the event of the given source.
+ * @param[source]: the source of the event which has caused the work.
+ * @param[seconds]: the time spent.
+ */
+void energy_account_busy(energy_source_t source, double seconds)
+{
+	if (seconds > 0.0)
+		s_info.counters[source].busy_time += seconds;
+}
+
+/*
+ * @brief Gets the number of the main loop iterations started by the events of the given source.
+ * @param[source]: the source of the events.
+ * @return: The number of wakeups.
+ */
+double energy_get_wakeups(energy_source_t source)
+{
+	return s_info.counters[source].wakeups;
+}
+
+/*
+ * @brief Counts the message sent to the EDJE script.
+ * @param[source]: the source of the event which has caused the message.
+ */
+void energy_account_message(energy_source_t source)
+{
+	s_info.counters[source].messages++;
+}
+
+/*
+ * @brief Counts the pixels composited by the canvas.
+ * @param[source]: the source of the event which has caused the rendering.
+ * @param[pixels]: the number of pixels of the updated area.
+ */
+void energy_account_pixels(energy_source_t source, unsigned long long pixels)
+{
+	s_info.counters[source].pixels += pixels;
+}
+
+/*
+ * @brief Counts the bytes of the decoded images.
+ * @param[source]: the source of the event which has caused the decoding.
+ * @param[bytes]: the size of the decoded image data.
+ */
+void energy_account_decoded(energy_source_t source, unsigned long long bytes)
+{
+	s_info.counters[source].bytes_decoded += bytes;
+}
+
+/*
+ * @brief Estimates the battery charge drawn by the watch face per day.
+ * The work per event is averaged over the events observed so far.
+ * @param[profile]: the number of events of each source per day.
+ * @return: The estimated charge in mAh.
+ */
+double energy_estimate_mah_per_day(const energy_day_profile_t *profile)
+{
+	double mah = 0.0;
+	int i;
+
+	if (!profile) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+		return 0.0;
+	}
+
+	for (i = 0; i < ENERGY_SOURCE_MAX; i++)
+		mah += profile->events[i] * _event_mah(i);
+
+	return mah;
+}
+
+/*
+ * @brief Gets the standard 24-hour usage profile defined in energy_budget.h.
+ * @param[profile]: the profile to be filled.
+ */
+void energy_get_standard_day_profile(energy_day_profile_t *profile)
+{
+	if (!profile) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+		return;
+	}
+
+	profile->events[ENERGY_SOURCE_STARTUP] = ENERGY_PROFILE_STARTUPS;
+	profile->events[ENERGY_SOURCE_TIME_TICK] = ENERGY_PROFILE_TIME_TICKS;
+	profile->events[ENERGY_SOURCE_AMBIENT_TICK] = ENERGY_PROFILE_AMBIENT_TICKS;
+	profile->events[ENERGY_SOURCE_BADGE] = ENERGY_PROFILE_BADGES;
+	profile->events[ENERGY_SOURCE_TOUCH] = ENERGY_PROFILE_TOUCHES;
+	profile->events[ENERGY_SOURCE_SENSOR] = ENERGY_PROFILE_SENSOR_BATCHES;
+}
+
+/*
+ * @brief Estimates the charge drawn during the standard day and compares it against ENERGY_BUDGET_MAH_PER_DAY.
+ * Every source of the profile must have been observed, the default work per event is never used here.
+ * @return: The function returns 'true' if the estimate is within the budget, otherwise 'false' is returned.
+ */
+bool energy_check_budget(void)
+{
+	energy_day_profile_t profile;
+	bool observed = true;
+	double mah;
+	int i;
+
+	energy_get_standard_day_profile(&profile);
+	mah = energy_estimate_mah_per_day(&profile);
+
+	for (i = 0; i < ENERGY_SOURCE_MAX; i++) {
+		dlog_print(DLOG_INFO, LOG_TAG, "energy budget: %-12s %6.0f of %6.0f events/day observed, %.4f mAh/day", s_source_names[i],
+				s_info.counters[i].events, profile.events[i], profile.events[i] * _event_mah(i));
+
+		if (profile.events[i] > 0.0 && s_info.counters[i].events == 0.0) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "energy budget: the %s source has not been observed.", s_source_names[i]);
+			observed = false;
+		}
+	}
+
+	if (!observed)
+		return false;
+
+	if (mah > ENERGY_BUDGET_MAH_PER_DAY) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "energy budget exceeded: %.3f mAh/day, budget %.3f mAh/day", mah, ENERGY_BUDGET_MAH_PER_DAY);
+		return false;
+	}
+
+	dlog_print(DLOG_INFO, LOG_TAG, "energy budget met: %.3f mAh/day, budget %.3f mAh/day", mah, ENERGY_BUDGET_MAH_PER_DAY);
+
+	return true;
+}
+
+/*
+ * @brief Converts the average work done per event of the given source into the charge.
+ * @param[source]: the source of the events.
+ * @return: The charge in mAh drawn per event.
+ */
+static double _event_mah(energy_source_t source)
+{
+	const struct _energy_counters *c = &s_info.counters[source];
+	const energy_device_model_t *m = &s_info.model;
+	double cpu_time;
+
+	if (c->events == 0.0)
+		c = &s_default_counters[source];
+
+	cpu_time = c->busy_time
+			+ c->wakeups * m->wakeup_ms / 1000.0
+			+ c->messages * m->message_us / 1000000.0
+			+ c->pixels * m->pixel_ns / 1000000000.0
+			+ c->bytes_decoded * m->decode_ns_per_byte / 1000000000.0;
+
+	return m->cpu_active_ma * cpu_time / c->events / 3600.0;
+}
+
+/*
+ * @brief Logs the counters and the estimate once per ENERGY_REPORT_PERIOD.
+ */
+static void _report(void)
+{
+	double now = ecore_time_get();
+	double elapsed = now - s_info.report_start;
+	energy_day_profile_t profile;
+	int i;
+
+	if (s_info.report_start == 0.0) {
+		s_info.report_start = now;
+		return;
+	}
+
+	if (elapsed < ENERGY_REPORT_PERIOD)
+		return;
+
+	for (i = 0; i < ENERGY_SOURCE_MAX; i++) {
+		const struct _energy_counters *c = &s_info.counters[i];
+
+		dlog_print(DLOG_DEBUG, LOG_TAG, "energy: %-12s events %.0f, wakeups %.0f, busy %.3f s, messages %.0f, pixels %.0f, decoded %.0f B",
+				s_source_names[i], c->events, c->wakeups, c->busy_time, c->messages, c->pixels, c->bytes_decoded);
+	}
+
+	energy_get_standard_day_profile(&profile);
+	dlog_print(DLOG_DEBUG, LOG_TAG, "energy: %.3f mAh/day estimated for the standard day", energy_estimate_mah_per_day(&profile));
+
+	s_info.report_start = now;
+}
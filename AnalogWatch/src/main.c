@@ -19,14 +19,86 @@
 #include <badge.h>
 #include "analogwatch.h"
 #include "view.h"
+#include "sensor_complication.h"
+#include "energy.h"
+#include "memory_accounting.h"
+#include "memory_budget.h"
+#if defined(ENERGY_BENCHMARK)
+#include "energy_budget.h"
+#endif
 
 #define APP_ID_CALL "com.samsung.call"
 #define APP_ID_MESSAGES "com.samsung.message"
 
+#if defined(ENERGY_BENCHMARK) && defined(MEMORY_BENCHMARK)
+#error "ENERGY_BENCHMARK and MEMORY_BENCHMARK cannot be built together."
+#endif
+
+#if defined(ENERGY_BENCHMARK)
+#define ENERGY_BENCHMARK_INTERVAL 0.01
+#define ENERGY_BENCHMARK_HOURS 24
+
+/*
+ * The events of the simulated day, each one is handled in its own main loop iteration.
+ */
+typedef enum {
+	BENCHMARK_EVENT_TIME_TICK,
+	BENCHMARK_EVENT_AMBIENT_TICK,
+	BENCHMARK_EVENT_BADGE,
+	BENCHMARK_EVENT_TAP_DOWN,
+	BENCHMARK_EVENT_TAP_UP,
+	BENCHMARK_EVENT_SENSOR,
+} benchmark_event_t;
+#endif
+
+#if defined(MEMORY_BENCHMARK)
+#define MEMORY_BENCHMARK_INTERVAL 0.01
+#define MEMORY_BENCHMARK_MINUTES (24 * 60)
+#define MEMORY_BENCHMARK_ACTIVE_MINUTES 5
+#endif
+
+static struct main_info {
+	app_control_h launch_handles[VIEW_ICON_ID_MAX];
+#if defined(ENERGY_BENCHMARK) || defined(MEMORY_BENCHMARK)
+	int benchmark_step;
+	bool benchmark_passed;
+#endif
+#if defined(ENERGY_BENCHMARK)
+	unsigned char *benchmark_events;
+	int benchmark_event_count;
+	current_time_t benchmark_time;
+	bool benchmark_ambient_mode;
+	int benchmark_taps;
+#endif
+#if defined(MEMORY_BENCHMARK)
+	size_t baseline_rss;
+#endif
+} s_info = {
+	.launch_handles = {NULL, },
+};
+
+static const char *s_launch_app_ids[VIEW_ICON_ID_MAX] = {
+	[VIEW_ICON_ID_MISSED_CALLS] = APP_ID_CALL,
+	[VIEW_ICON_ID_UNREAD_MESSAGES] = APP_ID_MESSAGES,
+};
+
 static void _badge_change_cb(unsigned int action, const char *app_id, unsigned int count, void *user_data);
 static void _icon_pressed_cb(view_icon_id_t id);
 static void _app_launch_request_cb(app_control_h request, app_control_h reply, app_control_result_e result, void *data);
 static bool _get_time(watch_time_h watch_time, current_time_t *current_time);
+static void _update_time(watch_time_h watch_time);
+static app_control_h _create_launch_handle(view_icon_id_t id);
+static void _destroy_launch_handles(void);
+#if defined(ENERGY_BENCHMARK)
+static int _spread(int total, int slot, int slots);
+static int _energy_benchmark_add_events(unsigned char *events);
+static bool _energy_benchmark_start(void);
+static void _energy_benchmark_tick(energy_source_t source);
+static Eina_Bool _energy_benchmark_cb(void *data);
+#endif
+#if defined(MEMORY_BENCHMARK)
+static Eina_Bool _memory_benchmark_cb(void *data);
+#endif
 
 /*
  * @brief The system language changed event callback function
@@ -82,6 +154,8 @@ void low_memory(app_event_info_h event_info, void* user_data)
 	/*
 	 * Takes necessary actions when system is running on low memory
 	 */
+	memory_report();
+
 	watch_app_exit();
 }
 
@@ -111,6 +185,9 @@ static bool app_create(int width, int height, void* user_data)
 	 */
 
 	app_event_handler_h handlers[5] = {NULL, };
+	int i;
+
+	energy_begin(ENERGY_SOURCE_STARTUP);
 
 	/*
 	 * Register callbacks for each system event
@@ -130,13 +207,39 @@ static bool app_create(int width, int height, void* user_data)
 	if (watch_app_add_event_handler(&handlers[APP_EVENT_DEVICE_ORIENTATION_CHANGED], APP_EVENT_DEVICE_ORIENTATION_CHANGED, device_orientation, NULL) != APP_ERROR_NONE)
 		dlog_print(DLOG_ERROR, LOG_TAG, "watch_app_add_event_handler () is failed");
 
-	view_create_with_size(width, height);
+#if defined(MEMORY_BENCHMARK)
+	s_info.baseline_rss = memory_get_rss();
+#endif
+
+	if (!view_create_with_size(width, height)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create the view.");
+		energy_end();
+		return false;
+	}
 
 	if (badge_register_changed_cb(_badge_change_cb, NULL) != BADGE_ERROR_NONE)
 		dlog_print(DLOG_ERROR, LOG_TAG, "badge_register_changed_cb () is failed");
 
+	for (i = 0; i < VIEW_ICON_ID_MAX; i++)
+		s_info.launch_handles[i] = _create_launch_handle(i);
+
 	view_set_icon_pressed_cb(_icon_pressed_cb);
 
+	if (SENSOR_COMPLICATION_ENABLED && !sensor_complication_create())
+		dlog_print(DLOG_WARN, LOG_TAG, "sensor complication is not available.");
+
+#if defined(ENERGY_BENCHMARK)
+	if (!_energy_benchmark_start())
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to start the energy benchmark.");
+#endif
+
+#if defined(MEMORY_BENCHMARK)
+	if (!ecore_timer_add(MEMORY_BENCHMARK_INTERVAL, _memory_benchmark_cb, NULL))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to start the memory benchmark.");
+#endif
+
+	energy_end();
+
 	return true;
 }
 
@@ -181,6 +284,10 @@ static void app_terminate(void *user_data)
 {
 	badge_unregister_changed_cb(_badge_change_cb);
 
+	_destroy_launch_handles();
+
+	sensor_complication_destroy();
+
 	view_destroy();
 }
 
@@ -191,10 +298,11 @@ static void app_terminate(void *user_data)
  */
 void app_time_tick(watch_time_h watch_time, void* user_data)
 {
-	current_time_t current_time = {0,};
+	energy_begin(ENERGY_SOURCE_TIME_TICK);
 
-	if (_get_time(watch_time, &current_time))
-		view_set_display_time(current_time);
+	_update_time(watch_time);
+
+	energy_end();
 }
 
 /*
@@ -204,7 +312,11 @@ void app_time_tick(watch_time_h watch_time, void* user_data)
  */
 void app_ambient_tick(watch_time_h watch_time, void* user_data)
 {
-	app_time_tick(watch_time, user_data);
+	energy_begin(ENERGY_SOURCE_AMBIENT_TICK);
+
+	_update_time(watch_time);
+
+	energy_end();
 }
 
 /*
@@ -217,6 +329,7 @@ void app_ambient_changed(bool ambient_mode, void* user_data)
 	 */
 
 	view_toggle_ambient_mode(ambient_mode);
+	sensor_complication_set_ambient_mode(ambient_mode);
 }
 
 /*
@@ -241,6 +354,11 @@ int main(int argc, char *argv[])
 	if (ret != APP_ERROR_NONE)
 		dlog_print(DLOG_ERROR, LOG_TAG, "watch_app_main() is failed. err = %d", ret);
 
+#if defined(ENERGY_BENCHMARK) || defined(MEMORY_BENCHMARK)
+	if (ret == APP_ERROR_NONE && !s_info.benchmark_passed)
+		return EXIT_FAILURE;
+#endif
+
 	return ret;
 }
 
@@ -256,49 +374,36 @@ static void _badge_change_cb(unsigned int action, const char *app_id, unsigned i
 	if (!app_id)
 		return;
 
+	energy_begin(ENERGY_SOURCE_BADGE);
+
 	if (strncmp(app_id, APP_ID_CALL, strlen(app_id)) == 0)
 		view_set_bagde_missed_calls(count);
 	else if (strncmp(app_id, APP_ID_MESSAGES, strlen(app_id)) == 0)
 		view_set_bagde_unread_messages(count);
+
+	energy_end();
 }
 
 /*
  * @brief The callback function invoked on application's icon tap.
+ * The launch handles are created once in app_create() and reused for every tap.
  * @param[id]: the identifier of the tapped application.
  */
 static void _icon_pressed_cb(view_icon_id_t id)
 {
-	app_control_h app_ctrl = NULL;
-	const char *app_id = NULL;
-
-	if (app_control_create(&app_ctrl) != APP_CONTROL_ERROR_NONE) {
-		dlog_print(DLOG_ERROR, LOG_TAG, "app_control_create() is failed.");
-		return;
-	}
-
-	switch (id) {
-	case VIEW_ICON_ID_MISSED_CALLS:
-		app_id = APP_ID_CALL;
-		break;
-	case VIEW_ICON_ID_UNREAD_MESSAGES:
-		app_id = APP_ID_MESSAGES;
-		break;
-	default:
+	if (id < 0 || id >= VIEW_ICON_ID_MAX) {
 		dlog_print(DLOG_WARN, LOG_TAG, "Unknown id of the tapped application's icon.");
-		app_control_destroy(app_ctrl);
 		return;
 	}
 
-	if (app_control_set_app_id(app_ctrl, app_id) != APP_CONTROL_ERROR_NONE) {
-		dlog_print(DLOG_ERROR, LOG_TAG, "app_control_set_app_id() is failed.");
-		app_control_destroy(app_ctrl);
-		return;
+	if (!s_info.launch_handles[id]) {
+		s_info.launch_handles[id] = _create_launch_handle(id);
+		if (!s_info.launch_handles[id])
+			return;
 	}
 
-	if (app_control_send_launch_request(app_ctrl, _app_launch_request_cb, (void *)app_id) != APP_CONTROL_ERROR_NONE)
+	if (app_control_send_launch_request(s_info.launch_handles[id], _app_launch_request_cb, (void *)s_launch_app_ids[id]) != APP_CONTROL_ERROR_NONE)
 		dlog_print(DLOG_ERROR, LOG_TAG, "app_control_send_launch_request() is failed.");
-
-	app_control_destroy(app_ctrl);
 }
 
 /*
@@ -362,3 +467,303 @@ static bool _get_time(watch_time_h watch_time, current_time_t *current_time)
 
 	return true;
 }
+
+/*
+ * @brief: Updates the displayed time and the complications on the time tick.
+ * @param[watch_time]: The date and time structure acquired in time_tick callback function.
+ */
+static void _update_time(watch_time_h watch_time)
+{
+	current_time_t current_time = {0,};
+
+	if (_get_time(watch_time, &current_time))
+		view_set_display_time(current_time);
+
+	sensor_complication_tick();
+}
+
+/*
+ * @brief: Creates the app_control handle used to launch the application bound to the given icon.
+ * @param[id]: the identifier of the application's icon.
+ * @return: The handle created or NULL on error.
+ */
+static app_control_h _create_launch_handle(view_icon_id_t id)
+{
+	app_control_h app_ctrl = NULL;
+	char *app_id = NULL;
+	int ret;
+
+	if (app_control_create(&app_ctrl) != APP_CONTROL_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "app_control_create() is failed.");
+		return NULL;
+	}
+
+#if defined(VIEW_TAP_BENCHMARK) || defined(ENERGY_BENCHMARK)
+	/*
+	 * The launched application would cover the face and stop its rendering, so the benchmarks
+	 * send the real launch requests to the face itself, which receives them in app_control().
+	 */
+	if (app_get_id(&app_id) != APP_ERROR_NONE)
+		dlog_print(DLOG_ERROR, LOG_TAG, "app_get_id() is failed.");
+#endif
+
+	ret = app_control_set_app_id(app_ctrl, app_id ? app_id : s_launch_app_ids[id]);
+	free(app_id);
+
+	if (ret != APP_CONTROL_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "app_control_set_app_id() is failed.");
+		app_control_destroy(app_ctrl);
+		return NULL;
+	}
+
+	return app_ctrl;
+}
+
+/*
+ * @brief: Destroys the app_control handles created for the application's icons.
+ */
+static void _destroy_launch_handles(void)
+{
+	int i;
+
+	for (i = 0; i < VIEW_ICON_ID_MAX; i++) {
+		if (!s_info.launch_handles[i])
+			continue;
+
+		app_control_destroy(s_info.launch_handles[i]);
+		s_info.launch_handles[i] = NULL;
+	}
+}
+
+#if defined(ENERGY_BENCHMARK)
+/*
+ * @brief: Gets the number of the events which fall into the slot when the events are spread evenly over the slots.
+ * @param[total]: the number of the events.
+ * @param[slot]: the index of the slot.
+ * @param[slots]: the number of the slots.
+ * @return: The number of the events in the slot.
+ */
+static int _spread(int total, int slot, int slots)
+{
+	return (slot + 1) * total / slots - slot * total / slots;
+}
+
+/*
+ * @brief: Lays out the events of the standard day defined in energy_budget.h in their chronological order.
+ * Each hour starts with its share of the active mode, in which the time ticks are interleaved with
+ * the sensor batches and the taps, followed by the ambient mode, in which the ambient ticks are
+ * interleaved with the sensor batches and the badge changes.
+ * @param[events]: the array to be filled or NULL to count the events only.
+ * @return: The number of the events of the day.
+ */
+static int _energy_benchmark_add_events(unsigned char *events)
+{
+	const int ticks = (int)ENERGY_PROFILE_TIME_TICKS / ENERGY_BENCHMARK_HOURS;
+	const int ambient_ticks = (int)ENERGY_PROFILE_AMBIENT_TICKS / ENERGY_BENCHMARK_HOURS;
+	int count = 0;
+	int hour, i, j, n;
+
+#define ADD_EVENT(event) do { if (events) events[count] = (event); count++; } while (0)
+
+	for (hour = 0; hour < ENERGY_BENCHMARK_HOURS; hour++) {
+		int batches = _spread((int)ENERGY_PROFILE_ACTIVE_SENSOR_BATCHES, hour, ENERGY_BENCHMARK_HOURS);
+		int taps = _spread((int)ENERGY_PROFILE_TOUCHES / 2, hour, ENERGY_BENCHMARK_HOURS);
+		int ambient_batches = _spread((int)ENERGY_PROFILE_AMBIENT_SENSOR_BATCHES, hour, ENERGY_BENCHMARK_HOURS);
+		int badges = _spread((int)ENERGY_PROFILE_BADGES, hour, ENERGY_BENCHMARK_HOURS);
+
+		for (i = 0; i < ticks; i++) {
+			ADD_EVENT(BENCHMARK_EVENT_TIME_TICK);
+
+			for (n = _spread(batches, i, ticks), j = 0; j < n; j++)
+				ADD_EVENT(BENCHMARK_EVENT_SENSOR);
+
+			for (n = _spread(taps, i, ticks), j = 0; j < n; j++) {
+				ADD_EVENT(BENCHMARK_EVENT_TAP_DOWN);
+				ADD_EVENT(BENCHMARK_EVENT_TAP_UP);
+			}
+		}
+
+		for (i = 0; i < ambient_ticks; i++) {
+			ADD_EVENT(BENCHMARK_EVENT_AMBIENT_TICK);
+
+			for (n = _spread(ambient_batches, i, ambient_ticks), j = 0; j < n; j++)
+				ADD_EVENT(BENCHMARK_EVENT_SENSOR);
+
+			for (n = _spread(badges, i, ambient_ticks), j = 0; j < n; j++)
+				ADD_EVENT(BENCHMARK_EVENT_BADGE);
+		}
+	}
+
+#undef ADD_EVENT
+
+	return count;
+}
+
+/*
+ * @brief: Lays out the simulated day and starts the timer which drives its events.
+ * @return: The function returns 'true' if the benchmark is started, otherwise 'false' is returned.
+ */
+static bool _energy_benchmark_start(void)
+{
+	s_info.benchmark_event_count = _energy_benchmark_add_events(NULL);
+
+	s_info.benchmark_events = malloc(s_info.benchmark_event_count);
+	if (!s_info.benchmark_events)
+		return false;
+
+	_energy_benchmark_add_events(s_info.benchmark_events);
+
+	if (!ecore_timer_add(ENERGY_BENCHMARK_INTERVAL, _energy_benchmark_cb, NULL)) {
+		free(s_info.benchmark_events);
+		s_info.benchmark_events = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * @brief: Handles the simulated time tick the same way app_time_tick() and app_ambient_tick() do.
+ * @param[source]: ENERGY_SOURCE_TIME_TICK or ENERGY_SOURCE_AMBIENT_TICK.
+ */
+static void _energy_benchmark_tick(energy_source_t source)
+{
+	current_time_t *current_time = &s_info.benchmark_time;
+
+	if (source == ENERGY_SOURCE_TIME_TICK)
+		current_time->second++;
+	else
+		current_time->minute++;
+
+	if (current_time->second == 60) {
+		current_time->second = 0;
+		current_time->minute++;
+	}
+
+	if (current_time->minute == 60) {
+		current_time->minute = 0;
+		current_time->hour = (current_time->hour + 1) % 24;
+	}
+
+	energy_begin(source);
+
+	view_set_display_time(*current_time);
+	sensor_complication_tick();
+
+	energy_end();
+}
+
+/*
+ * @brief: The timer callback which drives the events of the simulated standard day: the time ticks,
+ * the ambient ticks, the badge changes, the taps and the sensor batches, through the same handlers
+ * as the real events. Once the day is over, the work measured for each source is checked against
+ * the budget and the application exits.
+ * @param[data]: the user data passed to the ecore_timer_add function.
+ * @return: ECORE_CALLBACK_RENEW until all the events of the day are processed.
+ */
+static Eina_Bool _energy_benchmark_cb(void *data)
+{
+	int step = s_info.benchmark_step++;
+	benchmark_event_t event;
+
+	if (step >= s_info.benchmark_event_count) {
+		free(s_info.benchmark_events);
+		s_info.benchmark_events = NULL;
+
+		s_info.benchmark_passed = energy_check_budget();
+
+		watch_app_exit();
+
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	event = s_info.benchmark_events[step];
+
+	if (event == BENCHMARK_EVENT_TIME_TICK && s_info.benchmark_ambient_mode) {
+		s_info.benchmark_ambient_mode = false;
+		app_ambient_changed(false, NULL);
+	} else if (event == BENCHMARK_EVENT_AMBIENT_TICK && !s_info.benchmark_ambient_mode) {
+		s_info.benchmark_ambient_mode = true;
+		app_ambient_changed(true, NULL);
+	}
+
+	switch (event) {
+	case BENCHMARK_EVENT_TIME_TICK:
+		_energy_benchmark_tick(ENERGY_SOURCE_TIME_TICK);
+		break;
+	case BENCHMARK_EVENT_AMBIENT_TICK:
+		_energy_benchmark_tick(ENERGY_SOURCE_AMBIENT_TICK);
+		break;
+	case BENCHMARK_EVENT_BADGE:
+		_badge_change_cb(0, step % 2 ? APP_ID_MESSAGES : APP_ID_CALL, step % 120, NULL);
+		break;
+	case BENCHMARK_EVENT_TAP_DOWN:
+		view_feed_icon_event(s_info.benchmark_taps % 2 ? VIEW_ICON_ID_UNREAD_MESSAGES : VIEW_ICON_ID_MISSED_CALLS, true);
+		break;
+	case BENCHMARK_EVENT_TAP_UP:
+		view_feed_icon_event(s_info.benchmark_taps++ % 2 ? VIEW_ICON_ID_UNREAD_MESSAGES : VIEW_ICON_ID_MISSED_CALLS, false);
+		break;
+	case BENCHMARK_EVENT_SENSOR:
+		sensor_complication_flush();
+		break;
+	}
+
+	return ECORE_CALLBACK_RENEW;
+}
+#endif
+
+#if defined(MEMORY_BENCHMARK)
+/*
+ * @brief: The timer callback which simulates a day minute by minute: the ambient ticks, a few minutes
+ * of the active mode each hour and the badge counters growing beyond 99. Once finished, the peak
+ * accounted usage and the peak RSS are checked against the budgets and the application exits.
+ * @param[data]: the user data passed to the ecore_timer_add function.
+ * @return: ECORE_CALLBACK_RENEW until the whole day is simulated.
+ */
+static Eina_Bool _memory_benchmark_cb(void *data)
+{
+	int minute = s_info.benchmark_step++;
+	current_time_t current_time = {minute / 60, minute % 60, 0};
+	size_t rss_growth;
+
+	if (minute < MEMORY_BENCHMARK_MINUTES) {
+		if (current_time.minute == 0)
+			app_ambient_changed(false, NULL);
+		else if (current_time.minute == MEMORY_BENCHMARK_ACTIVE_MINUTES)
+			app_ambient_changed(true, NULL);
+
+		view_set_display_time(current_time);
+		sensor_complication_tick();
+
+		if (minute % 7 == 0)
+			view_set_bagde_missed_calls(minute / 7 % 120);
+
+		if (minute % 11 == 0)
+			view_set_bagde_unread_messages(minute / 11 % 120);
+
+		return ECORE_CALLBACK_RENEW;
+	}
+
+	memory_report();
+
+	/*
+	 * The baseline is the resident set of the application framework and the libraries measured before
+	 * the face is created, the growth beyond it is caused by the face and must fit into the budget.
+	 */
+	rss_growth = memory_get_peak_rss();
+	rss_growth = rss_growth > s_info.baseline_rss ? rss_growth - s_info.baseline_rss : 0;
+
+	s_info.benchmark_passed = memory_get_total_peak() <= MEMORY_BUDGET_BYTES && rss_growth <= MEMORY_BUDGET_BYTES;
+
+	if (s_info.benchmark_passed)
+		dlog_print(DLOG_INFO, LOG_TAG, "memory budget met: peak %zu B of %zu B, peak RSS growth %zu B of %zu B.",
+				memory_get_total_peak(), (size_t)MEMORY_BUDGET_BYTES, rss_growth, (size_t)MEMORY_BUDGET_BYTES);
+	else
+		dlog_print(DLOG_ERROR, LOG_TAG, "memory budget exceeded: peak %zu B of %zu B, peak RSS growth %zu B of %zu B.",
+				memory_get_total_peak(), (size_t)MEMORY_BUDGET_BYTES, rss_growth, (size_t)MEMORY_BUDGET_BYTES);
+
+	watch_app_exit();
+
+	return ECORE_CALLBACK_CANCEL;
+}
+#endif
@@ -0,0 +1,399 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "analogwatch.h"
+#include "memory_accounting.h"
+#include "memory_budget.h"
+
+#define PROC_STATUS_PATH "/proc/self/status"
+#define PROC_SMAPS_PATH "/proc/self/smaps"
+
+typedef union {
+	struct {
+		size_t size;
+		memory_subsystem_t subsystem;
+	} info;
+	long double align;
+} alloc_header_t;
+
+struct _memory_usage {
+	size_t current;
+	size_t peak;
+	memory_evict_cb evict_cb;
+	void *evict_data;
+};
+
+static struct memory_info {
+	size_t budget;
+	size_t total;
+	size_t total_peak;
+	struct _memory_usage usage[MEMORY_SUBSYSTEM_MAX];
+} s_info = {
+	.budget = MEMORY_BUDGET_BYTES,
+	.total = 0,
+	.total_peak = 0,
+};
+
+static const char *s_subsystem_names[MEMORY_SUBSYSTEM_MAX] = {
+	[MEMORY_SUBSYSTEM_VIEW] = "view",
+	[MEMORY_SUBSYSTEM_LAYOUT] = "layout",
+	[MEMORY_SUBSYSTEM_IMAGES] = "images",
+	[MEMORY_SUBSYSTEM_TEXT] = "text",
+	[MEMORY_SUBSYSTEM_BADGES] = "badges",
+	[MEMORY_SUBSYSTEM_SENSORS] = "sensors",
+};
+
+static void _account(memory_subsystem_t subsystem, size_t size);
+static size_t _read_status_bytes(const char *format);
+static bool _make_room(size_t size);
+
+/*
+ * @brief Sets the total memory budget. Optional assets are evicted if the current usage exceeds the new budget.
+ * @param[budget]: the budget in bytes.
+ */
+void memory_set_budget(size_t budget)
+{
+	s_info.budget = budget;
+
+	_make_room(0);
+}
+
+/*
+ * @brief Accounts the memory which is required by the subsystem. The optional assets are evicted
+ * if the reservation does not fit into the budget, and the reservation is refused if it still does not fit.
+ * The caller must not use the memory if the reservation is refused.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[size]: the size in bytes.
+ * @return: The function returns 'true' if the memory is reserved, otherwise 'false' is returned.
+ */
+bool memory_reserve(memory_subsystem_t subsystem, size_t size)
+{
+	if (!_make_room(size)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "%s reservation of %zu bytes refused: %zu of %zu bytes used.",
+				s_subsystem_names[subsystem], size, s_info.total, s_info.budget);
+		return false;
+	}
+
+	_account(subsystem, size);
+
+	return true;
+}
+
+/*
+ * @brief Accounts the memory of an optional asset. The reservation is refused if it does not fit into the budget.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[size]: the size in bytes.
+ * @return: The function returns 'true' if the memory is reserved, otherwise 'false' is returned.
+ */
+bool memory_reserve_optional(memory_subsystem_t subsystem, size_t size)
+{
+	if (s_info.total + size > s_info.budget) {
+		dlog_print(DLOG_WARN, LOG_TAG, "optional %s asset of %zu bytes refused: %zu of %zu bytes used.",
+				s_subsystem_names[subsystem], size, s_info.total, s_info.budget);
+		return false;
+	}
+
+	_account(subsystem, size);
+
+	return true;
+}
+
+/*
+ * @brief Releases the memory reserved by the subsystem.
+ * @param[subsystem]: the subsystem which used the memory.
+ * @param[size]: the size in bytes.
+ */
+void memory_release(memory_subsystem_t subsystem, size_t size)
+{
+	struct _memory_usage *usage = &s_info.usage[subsystem];
+
+	if (size > usage->current) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "%s releases more memory than reserved.", s_subsystem_names[subsystem]);
+		size = usage->current;
+	}
+
+	usage->current -= size;
+	s_info.total -= size;
+}
+
+/*
+ * @brief Replaces the usage of the subsystem with the measured one, e.g. the size of the decoded surfaces.
+ * The optional assets are evicted if the usage does not fit into the budget. The memory is in use already,
+ * so the usage is accounted even if it still does not fit and the caller is expected to free some of it.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[size]: the size in bytes.
+ * @return: The function returns 'true' if the usage is within the budget, otherwise 'false' is returned.
+ */
+bool memory_set_usage(memory_subsystem_t subsystem, size_t size)
+{
+	bool fits;
+
+	memory_release(subsystem, s_info.usage[subsystem].current);
+
+	fits = _make_room(size);
+	_account(subsystem, size);
+
+	if (!fits)
+		dlog_print(DLOG_ERROR, LOG_TAG, "memory budget exceeded by %s: %zu of %zu bytes used.",
+				s_subsystem_names[subsystem], s_info.total, s_info.budget);
+
+	return fits;
+}
+
+/*
+ * @brief Sets the callback function which releases the optional assets of the subsystem when the budget is exceeded.
+ * The callback function is expected to call memory_release() for the memory freed.
+ * @param[subsystem]: the subsystem which owns the optional assets.
+ * @param[cb]: the callback function to be attached or NULL to detach it.
+ * @param[data]: the user data passed to the callback function.
+ */
+void memory_set_evict_cb(memory_subsystem_t subsystem, memory_evict_cb cb, void *data)
+{
+	s_info.usage[subsystem].evict_cb = cb;
+	s_info.usage[subsystem].evict_data = data;
+}
+
+/*
+ * @brief Allocates the memory accounted to the subsystem.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[size]: the size in bytes.
+ * @return: The pointer to the allocated memory or NULL on error, including the refused reservation.
+ * It must be freed with memory_free().
+ */
+void *memory_malloc(memory_subsystem_t subsystem, size_t size)
+{
+	alloc_header_t *header = NULL;
+
+	if (!memory_reserve(subsystem, size))
+		return NULL;
+
+	header = malloc(sizeof(alloc_header_t) + size);
+	if (!header) {
+		memory_release(subsystem, size);
+		return NULL;
+	}
+
+	header->info.size = size;
+	header->info.subsystem = subsystem;
+
+	return header + 1;
+}
+
+/*
+ * @brief Allocates the zeroed memory accounted to the subsystem.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[count]: the number of elements.
+ * @param[size]: the size of an element in bytes.
+ * @return: The pointer to the allocated memory or NULL on error. It must be freed with memory_free().
+ */
+void *memory_calloc(memory_subsystem_t subsystem, size_t count, size_t size)
+{
+	void *ptr = NULL;
+
+	if (size && count > ((size_t)-1 - sizeof(alloc_header_t)) / size)
+		return NULL;
+
+	ptr = memory_malloc(subsystem, count * size);
+	if (ptr)
+		memset(ptr, 0, count * size);
+
+	return ptr;
+}
+
+/*
+ * @brief Frees the memory allocated with memory_malloc() or memory_calloc().
+ * @param[ptr]: the pointer to the memory. NULL is ignored.
+ */
+void memory_free(void *ptr)
+{
+	alloc_header_t *header = NULL;
+
+	if (!ptr)
+		return;
+
+	header = (alloc_header_t *)ptr - 1;
+	memory_release(header->info.subsystem, header->info.size);
+
+	free(header);
+}
+
+/*
+ * @brief Gets the current memory usage of the subsystem.
+ * @param[subsystem]: the subsystem.
+ * @return: The usage in bytes.
+ */
+size_t memory_get_current(memory_subsystem_t subsystem)
+{
+	return s_info.usage[subsystem].current;
+}
+
+/*
+ * @brief Gets the peak memory usage of the subsystem.
+ * @param[subsystem]: the subsystem.
+ * @return: The peak usage in bytes.
+ */
+size_t memory_get_peak(memory_subsystem_t subsystem)
+{
+	return s_info.usage[subsystem].peak;
+}
+
+/*
+ * @brief Gets the current memory usage of all the subsystems.
+ * @return: The usage in bytes.
+ */
+size_t memory_get_total_current(void)
+{
+	return s_info.total;
+}
+
+/*
+ * @brief Gets the peak memory usage of all the subsystems.
+ * @return: The peak usage in bytes.
+ */
+size_t memory_get_total_peak(void)
+{
+	return s_info.total_peak;
+}
+
+/*
+ * @brief Gets the peak resident set size of the process.
+ * @return: The peak RSS in bytes or 0 if it cannot be read.
+ */
+size_t memory_get_peak_rss(void)
+{
+	return _read_status_bytes("VmHWM: %zu kB");
+}
+
+/*
+ * @brief Gets the current resident set size of the process.
+ * @return: The resident set size in bytes.
+ */
+size_t memory_get_rss(void)
+{
+	return _read_status_bytes("VmRSS: %zu kB");
+}
+
+/*
+ * @brief Gets the proportional set size of the process, i.e. its private memory plus its share of
+ * the memory shared with the other processes, such as the other instances of the face.
+ * @return: The proportional set size in bytes.
+ */
+size_t memory_get_pss(void)
+{
+	char line[256] = {0,};
+	size_t pss_kb = 0;
+	size_t total_kb = 0;
+	FILE *file = fopen(PROC_SMAPS_PATH, "r");
+
+	if (!file) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open '%s'.", PROC_SMAPS_PATH);
+		return 0;
+	}
+
+	while (fgets(line, sizeof(line), file)) {
+		if (sscanf(line, "Pss: %zu kB", &pss_kb) == 1)
+			total_kb += pss_kb;
+	}
+
+	fclose(file);
+
+	return total_kb * 1024;
+}
+
+/*
+ * @brief Logs the current and the peak memory usage of each subsystem.
+ */
+void memory_report(void)
+{
+	int i;
+
+	for (i = 0; i < MEMORY_SUBSYSTEM_MAX; i++)
+		dlog_print(DLOG_INFO, LOG_TAG, "memory: %-8s current %zu B, peak %zu B", s_subsystem_names[i],
+				s_info.usage[i].current, s_info.usage[i].peak);
+
+	dlog_print(DLOG_INFO, LOG_TAG, "memory: total current %zu B, peak %zu B, budget %zu B, peak RSS %zu B, PSS %zu B",
+			s_info.total, s_info.total_peak, s_info.budget, memory_get_peak_rss(), memory_get_pss());
+}
+
+/*
+ * @brief Adds the size to the usage of the subsystem and updates the peaks.
+ * @param[subsystem]: the subsystem which uses the memory.
+ * @param[size]: the size in bytes.
+ */
+static void _account(memory_subsystem_t subsystem, size_t size)
+{
+	struct _memory_usage *usage = &s_info.usage[subsystem];
+
+	usage->current += size;
+	if (usage->current > usage->peak)
+		usage->peak = usage->current;
+
+	s_info.total += size;
+	if (s_info.total > s_info.total_peak)
+		s_info.total_peak = s_info.total;
+}
+
+/*
+ * @brief Reads the size from the process status.
+ * @param[format]: the scanf format of the status line holding the size in kilobytes.
+ * @return: The size in bytes or 0 if it is not found.
+ */
+static size_t _read_status_bytes(const char *format)
+{
+	char line[128] = {0,};
+	size_t size_kb = 0;
+	FILE *file = fopen(PROC_STATUS_PATH, "r");
+
+	if (!file) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open '%s'.", PROC_STATUS_PATH);
+		return 0;
+	}
+
+	while (fgets(line, sizeof(line), file)) {
+		if (sscanf(line, format, &size_kb) == 1)
+			break;
+	}
+
+	fclose(file);
+
+	return size_kb * 1024;
+}
+
+/*
+ * @brief Invokes the eviction callbacks, starting from the last subsystem, until the given size
+ * fits into the budget along with the current usage.
+ * @param[size]: the size in bytes to be made room for.
+ * @return: The function returns 'true' if the size fits into the budget, otherwise 'false' is returned.
+ */
+static bool _make_room(size_t size)
+{
+	struct _memory_usage *usage = NULL;
+	int i;
+
+	for (i = MEMORY_SUBSYSTEM_MAX - 1; i >= 0 && s_info.total + size > s_info.budget; i--) {
+		usage = &s_info.usage[i];
+		if (!usage->evict_cb)
+			continue;
+
+		dlog_print(DLOG_WARN, LOG_TAG, "evicting optional %s assets.", s_subsystem_names[i]);
+		usage->evict_cb(usage->evict_data);
+	}
+
+	return s_info.total + size <= s_info.budget;
+}
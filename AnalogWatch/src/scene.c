@@ -0,0 +1,481 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "analogwatch.h"
+#include "scene.h"
+#include "asset_store.h"
+#include "view_defines.h"
+
+#define TEXTBLOCK_STYLE_FORMAT "DEFAULT='%s'"
+
+static struct scene_info {
+	const scene_t *scene;
+	Evas_Object **objects;
+	Evas_Textblock_Style **styles;
+	char res_path[PATH_MAX];
+	int hand_hour;
+	int hand_minute;
+	int hand_second;
+	bool ambient_mode;
+} s_info = {
+	.scene = NULL,
+	.objects = NULL,
+	.styles = NULL,
+	.hand_hour = -1,
+	.hand_minute = -1,
+	.hand_second = -1,
+	.ambient_mode = false,
+};
+
+static int _find_part(const char *part_name);
+#if ASSET_STORE_ENABLED
+static void _attach_asset_store(Evas *evas);
+static bool _set_shared_image(Evas_Object *obj, const char *image);
+#endif
+static Evas_Object *_create_part_object(Evas *evas, int index);
+static void _set_image(Evas_Object *obj, const char *image);
+static void _rotate_part(int index, double angle);
+static void _set_counter(const scene_counter_t *counter, int value);
+static void _pressed_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+static void _pressed_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+
+/*
+ * @brief Finds the scene generated for the given resolution.
+ * @param[scenes]: the scenes generated for each of the target resolutions.
+ * @param[count]: the number of the scenes.
+ * @param[width]: the width of the window.
+ * @param[height]: the height of the window.
+ * @return: The scene found or NULL if the resolution is not a target one.
+ */
+const scene_t *scene_find(const scene_t *scenes, int count, int width, int height)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (scenes[i].width == width && scenes[i].height == height)
+			return &scenes[i];
+
+	return NULL;
+}
+
+/*
+ * @brief Creates the canvas objects of the scene's parts at their precomputed geometry.
+ * @param[win]: the window the scene is drawn in.
+ * @param[scene]: the scene to be drawn.
+ * @return: The function returns 'true' if the scene is created, otherwise 'false' is returned.
+ */
+bool scene_create(Evas_Object *win, const scene_t *scene)
+{
+	Evas *evas = NULL;
+	char *res_path = NULL;
+	int i;
+
+	if (!win || !scene) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+		return false;
+	}
+
+	res_path = app_get_resource_path();
+	if (!res_path) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to get resource path.");
+		return false;
+	}
+
+	snprintf(s_info.res_path, sizeof(s_info.res_path), "%s", res_path);
+	free(res_path);
+
+	s_info.objects = calloc(scene->part_count, sizeof(Evas_Object *));
+	s_info.styles = calloc(scene->part_count, sizeof(Evas_Textblock_Style *));
+	if (!s_info.objects || !s_info.styles) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to allocate the scene.");
+		scene_destroy();
+		return false;
+	}
+
+	s_info.scene = scene;
+	evas = evas_object_evas_get(win);
+
+#if ASSET_STORE_ENABLED
+	_attach_asset_store(evas);
+#endif
+
+	for (i = 0; i < scene->part_count; i++)
+		s_info.objects[i] = _create_part_object(evas, i);
+
+	s_info.hand_hour = _find_part(PART_HAND_HOUR);
+	s_info.hand_minute = _find_part(PART_HAND_MINUTE);
+	s_info.hand_second = _find_part(PART_HAND_SECOND);
+
+	return true;
+}
+
+/*
+ * @brief Applies the frame state to the scene. This is the native counterpart of the
+ * MSG_ID_SET_FRAME_STATE handler of the EDJE script.
+ * @param[values]: the frame state fields indexed with FRAME_STATE_IDX_*.
+ * @param[dirty]: the FRAME_STATE_DIRTY_* flags of the fields to be applied.
+ */
+void scene_apply_frame_state(const int *values, int dirty)
+{
+	double hh, mm, ss;
+	int i;
+
+	if (!s_info.scene || values[FRAME_STATE_IDX_VERSION] != FRAME_STATE_VERSION)
+		return;
+
+	if (dirty & FRAME_STATE_DIRTY_AMBIENT_MODE) {
+		s_info.ambient_mode = values[FRAME_STATE_IDX_AMBIENT_MODE] != 0;
+
+		if (s_info.hand_second >= 0) {
+			if (s_info.ambient_mode)
+				evas_object_hide(s_info.objects[s_info.hand_second]);
+			else
+				evas_object_show(s_info.objects[s_info.hand_second]);
+		}
+	}
+
+	if (dirty & FRAME_STATE_DIRTY_TIME) {
+		hh = values[FRAME_STATE_IDX_HOUR];
+		mm = values[FRAME_STATE_IDX_MINUTE];
+		ss = values[FRAME_STATE_IDX_SECOND];
+
+		_rotate_part(s_info.hand_hour, hh * 360.0 / 12.0 + mm * 360.0 / 12.0 / 60.0);
+		_rotate_part(s_info.hand_minute, mm * 360.0 / 60.0);
+
+		if (!s_info.ambient_mode)
+			_rotate_part(s_info.hand_second, ss * 360.0 / 60.0);
+	}
+
+	for (i = 0; i < s_info.scene->counter_count; i++) {
+		const scene_counter_t *counter = &s_info.scene->counters[i];
+
+		if (dirty & counter->dirty_flag)
+			_set_counter(counter, values[counter->frame_state_idx]);
+	}
+}
+
+/*
+ * @brief Gets the canvas object of the scene's part.
+ * @param[part_name]: the name of the part as defined in main.edc.
+ * @return: The object of the part or NULL if there is no such part.
+ */
+Evas_Object *scene_part_object_get(const char *part_name)
+{
+	int index = _find_part(part_name);
+
+	if (index < 0)
+		return NULL;
+
+	return s_info.objects[index];
+}
+
+/*
+ * @brief Checks whether the image of the scene's part is shared with the other instances of the face.
+ * @param[part_name]: the name of the part as defined in main.edc.
+ * @return: The function returns 'true' if the part's image is mapped from the asset store, otherwise 'false' is returned.
+ */
+bool scene_part_is_shared(const char *part_name)
+{
+#if ASSET_STORE_ENABLED
+	int index = _find_part(part_name);
+
+	return index >= 0 && asset_store_image_get(s_info.scene->parts[index].image, NULL, NULL, NULL) != NULL;
+#else
+	return false;
+#endif
+}
+
+/*
+ * @brief Deletes the canvas objects of the scene. The asset store is detached afterwards, as the
+ * objects use its images.
+ */
+void scene_destroy(void)
+{
+	int i;
+
+	for (i = 0; s_info.scene && i < s_info.scene->part_count; i++) {
+		if (s_info.objects && s_info.objects[i])
+			evas_object_del(s_info.objects[i]);
+
+		if (s_info.styles && s_info.styles[i])
+			evas_textblock_style_free(s_info.styles[i]);
+	}
+
+	free(s_info.objects);
+	free(s_info.styles);
+
+#if ASSET_STORE_ENABLED
+	asset_store_detach();
+#endif
+
+	s_info.objects = NULL;
+	s_info.styles = NULL;
+	s_info.scene = NULL;
+	s_info.hand_hour = -1;
+	s_info.hand_minute = -1;
+	s_info.hand_second = -1;
+}
+
+/*
+ * @brief Finds the index of the part within the scene.
+ * @param[part_name]: the name of the part.
+ * @return: The index of the part or -1 if there is no such part.
+ */
+static int _find_part(const char *part_name)
+{
+	int i;
+
+	if (!s_info.scene || !part_name)
+		return -1;
+
+	for (i = 0; i < s_info.scene->part_count; i++)
+		if (strcmp(s_info.scene->parts[i].name, part_name) == 0)
+			return i;
+
+	return -1;
+}
+
+/*
+ * @brief Creates the canvas object of the part.
+ * @param[evas]: the canvas.
+ * @param[index]: the index of the part within the scene.
+ * @return: The object created.
+ */
+static Evas_Object *_create_part_object(Evas *evas, int index)
+{
+	const scene_part_t *part = &s_info.scene->parts[index];
+	char style[256] = {0,};
+	Evas_Object *obj = NULL;
+
+	switch (part->type) {
+	case SCENE_PART_IMAGE:
+		obj = evas_object_image_filled_add(evas);
+		_set_image(obj, part->image);
+
+		if (part->pressed_image) {
+			evas_object_event_callback_add(obj, EVAS_CALLBACK_MOUSE_DOWN, _pressed_mouse_down_cb, part);
+			evas_object_event_callback_add(obj, EVAS_CALLBACK_MOUSE_UP, _pressed_mouse_up_cb, part);
+		}
+		break;
+	case SCENE_PART_TEXTBLOCK:
+		obj = evas_object_textblock_add(evas);
+
+		s_info.styles[index] = evas_textblock_style_new();
+		snprintf(style, sizeof(style), TEXTBLOCK_STYLE_FORMAT, part->text_style ? part->text_style : "");
+		evas_textblock_style_set(s_info.styles[index], style);
+		evas_object_textblock_style_set(obj, s_info.styles[index]);
+		break;
+	case SCENE_PART_RECT:
+	default:
+		obj = evas_object_rectangle_add(evas);
+		evas_object_color_set(obj, part->color[0], part->color[1], part->color[2], part->color[3]);
+		break;
+	}
+
+	evas_object_move(obj, part->x, part->y);
+	evas_object_resize(obj, part->w, part->h);
+	evas_object_pass_events_set(obj, !part->mouse_events);
+	evas_object_repeat_events_set(obj, part->repeat_events);
+
+	/*
+	 * Fully transparent rectangles are used as the containers for the geometry only.
+	 */
+	if (part->visible && !(part->type == SCENE_PART_RECT && part->color[3] == 0))
+		evas_object_show(obj);
+
+	return obj;
+}
+
+/*
+ * @brief Sets the image file relative to the resource directory.
+ * @param[obj]: the image object.
+ * @param[image]: the path of the image relative to the resource directory.
+ */
+static void _set_image(Evas_Object *obj, const char *image)
+{
+	char path[PATH_MAX] = {0,};
+
+	if (!image)
+		return;
+
+#if ASSET_STORE_ENABLED
+	if (_set_shared_image(obj, image))
+		return;
+#endif
+
+	snprintf(path, sizeof(path), "%s%s", s_info.res_path, image);
+	evas_object_image_file_set(obj, path, NULL);
+
+	if (evas_object_image_load_error_get(obj) != 0)
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to load '%s'.", path);
+}
+
+#if ASSET_STORE_ENABLED
+/*
+ * @brief Attaches to the asset store holding all the images of the scene.
+ * @param[evas]: the canvas used to decode the images, if they are not published yet.
+ */
+static void _attach_asset_store(Evas *evas)
+{
+	const char *images[ASSET_STORE_MAX_ENTRIES] = {NULL,};
+	const char *candidates[2];
+	int count = 0;
+	int i, j, k;
+
+	for (i = 0; i < s_info.scene->part_count; i++) {
+		candidates[0] = s_info.scene->parts[i].image;
+		candidates[1] = s_info.scene->parts[i].pressed_image;
+
+		for (j = 0; j < 2; j++) {
+			if (!candidates[j])
+				continue;
+
+			for (k = 0; k < count && strcmp(images[k], candidates[j]) != 0; k++)
+				;
+
+			if (k < count)
+				continue;
+
+			if (count == ASSET_STORE_MAX_ENTRIES) {
+				dlog_print(DLOG_WARN, LOG_TAG, "too many images for the asset store.");
+				return;
+			}
+
+			images[count++] = candidates[j];
+		}
+	}
+
+	if (!asset_store_attach(evas, s_info.res_path, images, count))
+		dlog_print(DLOG_WARN, LOG_TAG, "the images are decoded privately.");
+}
+
+/*
+ * @brief Sets the image's pixels mapped from the asset store. The pixels are premultiplied, so the
+ * canvas uses them as they are, without a copy, and it never frees them. The mapping is copy-on-write,
+ * so any write of the canvas stays private to this instance.
+ * The canvas allocates a buffer of the image's size on evas_object_image_size_set(), which is
+ * freed when it is replaced by the mapped pixels, so only one image at a time is held twice.
+ * @param[obj]: the image object.
+ * @param[image]: the path of the image relative to the resource directory.
+ * @return: The function returns 'true' if the image is in the store, otherwise 'false' is returned.
+ */
+static bool _set_shared_image(Evas_Object *obj, const char *image)
+{
+	void *pixels = NULL;
+	bool alpha = false;
+	int w, h;
+
+	pixels = asset_store_image_get(image, &w, &h, &alpha);
+	if (!pixels)
+		return false;
+
+	evas_object_image_size_set(obj, w, h);
+	evas_object_image_alpha_set(obj, alpha);
+	evas_object_image_data_set(obj, pixels);
+	evas_object_image_data_update_add(obj, 0, 0, w, h);
+
+	return true;
+}
+#endif
+
+/*
+ * @brief Rotates the part around its map rotation centre.
+ * @param[index]: the index of the part within the scene.
+ * @param[angle]: the angle in degrees.
+ */
+static void _rotate_part(int index, double angle)
+{
+	const scene_part_t *part = NULL;
+	Evas_Map *map = NULL;
+
+	if (index < 0)
+		return;
+
+	part = &s_info.scene->parts[index];
+	if (!part->map_rotation)
+		return;
+
+	map = evas_map_new(4);
+	if (!map)
+		return;
+
+	evas_map_util_points_populate_from_geometry(map, part->x, part->y, part->w, part->h, 0);
+	evas_map_util_rotate(map, angle, part->center_x, part->center_y);
+	evas_map_smooth_set(map, EINA_TRUE);
+
+	evas_object_map_set(s_info.objects[index], map);
+	evas_object_map_enable_set(s_info.objects[index], EINA_TRUE);
+
+	evas_map_free(map);
+}
+
+/*
+ * @brief Displays the counter's value.
+ * @param[counter]: the counter to be displayed.
+ * @param[value]: the value of the counter.
+ */
+static void _set_counter(const scene_counter_t *counter, int value)
+{
+	Evas_Object *text = s_info.objects[counter->text_part];
+	Evas_Object *badge = counter->badge_part >= 0 ? s_info.objects[counter->badge_part] : NULL;
+	char text_buff[16] = {0,};
+
+	if (value <= 0) {
+		evas_object_hide(text);
+		if (badge)
+			evas_object_hide(badge);
+		return;
+	}
+
+	if (counter->max_value > 0 && value > counter->max_value)
+		snprintf(text_buff, sizeof(text_buff), "%d+", counter->max_value);
+	else
+		snprintf(text_buff, sizeof(text_buff), "%d", value);
+
+	evas_object_textblock_text_markup_set(text, text_buff);
+	evas_object_show(text);
+
+	if (badge)
+		evas_object_show(badge);
+}
+
+/*
+ * @brief The callback function invoked on mouse down event over the part with the pressed image.
+ * @param[data]: the part description.
+ * @param[e]: the canvas.
+ * @param[obj]: the image object of the part.
+ * @param[event_info]: not used.
+ */
+static void _pressed_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	const scene_part_t *part = (const scene_part_t *)data;
+
+	_set_image(obj, part->pressed_image);
+}
+
+/*
+ * @brief The callback function invoked on mouse up event over the part with the pressed image.
+ * @param[data]: the part description.
+ * @param[e]: the canvas.
+ * @param[obj]: the image object of the part.
+ * @param[event_info]: not used.
+ */
+static void _pressed_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	const scene_part_t *part = (const scene_part_t *)data;
+
+	_set_image(obj, part->image);
+}
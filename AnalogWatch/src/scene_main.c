@@ -0,0 +1,460 @@
+/*
+ * Generated by tools/edc2scene.py from main.edc. Do not edit.
+ */
+
+#include "scene.h"
+#include "view_defines.h"
+
+static const scene_part_t s_parts_360x360[] = {
+	{
+		.name = "background",
+		.type = SCENE_PART_IMAGE,
+		.x = 0, .y = 0, .w = 360, .h = 360,
+		.image = "images/cipher_board_bg.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "icon_left",
+		.type = SCENE_PART_RECT,
+		.x = 87, .y = 142, .w = 80, .h = 78,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {0, 0, 0, 0},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls",
+		.type = SCENE_PART_IMAGE,
+		.x = 87, .y = 154, .w = 65, .h = 66,
+		.image = "images/icon_missed_calls.png",
+		.pressed_image = "images/icon_missed_calls_pressed.png",
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = true,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls_badge",
+		.type = SCENE_PART_IMAGE,
+		.x = 132, .y = 142, .w = 35, .h = 35,
+		.image = "images/badge.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls_badge_counter",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 132, .y = 142, .w = 35, .h = 35,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=18 align=center color=#ffffffff style=shadow,bottom shadow_color=#999999ff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "icon_right",
+		.type = SCENE_PART_RECT,
+		.x = 200, .y = 142, .w = 80, .h = 78,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {0, 0, 0, 0},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages",
+		.type = SCENE_PART_IMAGE,
+		.x = 200, .y = 154, .w = 65, .h = 66,
+		.image = "images/icon_unread_messages.png",
+		.pressed_image = "images/icon_unread_messages_pressed.png",
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = true,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages_badge",
+		.type = SCENE_PART_IMAGE,
+		.x = 245, .y = 142, .w = 35, .h = 35,
+		.image = "images/badge.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages_badge_counter",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 245, .y = 142, .w = 35, .h = 35,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=18 align=center color=#ffffffff style=shadow,bottom shadow_color=#999999ff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "steps",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 87, .y = 220, .w = 65, .h = 27,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=16 align=center color=#ffffffff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "heart_rate",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 200, .y = 220, .w = 65, .h = 27,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=16 align=center color=#ffffffff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "hands_center",
+		.type = SCENE_PART_IMAGE,
+		.x = 172, .y = 172, .w = 18, .h = 18,
+		.image = "images/hands_center.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "hand_hour",
+		.type = SCENE_PART_IMAGE,
+		.x = 176, .y = 95, .w = 12, .h = 85,
+		.image = "images/hand_hour.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 180, .center_y = 180,
+	},
+	{
+		.name = "hand_minute",
+		.type = SCENE_PART_IMAGE,
+		.x = 176, .y = 74, .w = 12, .h = 106,
+		.image = "images/hand_minute.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 180, .center_y = 180,
+	},
+	{
+		.name = "hand_second",
+		.type = SCENE_PART_IMAGE,
+		.x = 173, .y = 65, .w = 18, .h = 9,
+		.image = "images/hand_second.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 180, .center_y = 180,
+	},
+};
+
+static const scene_part_t s_parts_320x320[] = {
+	{
+		.name = "background",
+		.type = SCENE_PART_IMAGE,
+		.x = 0, .y = 0, .w = 320, .h = 320,
+		.image = "images/cipher_board_bg.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "icon_left",
+		.type = SCENE_PART_RECT,
+		.x = 77, .y = 127, .w = 71, .h = 68,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {0, 0, 0, 0},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls",
+		.type = SCENE_PART_IMAGE,
+		.x = 77, .y = 137, .w = 57, .h = 58,
+		.image = "images/icon_missed_calls.png",
+		.pressed_image = "images/icon_missed_calls_pressed.png",
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = true,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls_badge",
+		.type = SCENE_PART_IMAGE,
+		.x = 116, .y = 127, .w = 32, .h = 30,
+		.image = "images/badge.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "missed_calls_badge_counter",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 116, .y = 127, .w = 32, .h = 30,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=18 align=center color=#ffffffff style=shadow,bottom shadow_color=#999999ff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "icon_right",
+		.type = SCENE_PART_RECT,
+		.x = 177, .y = 127, .w = 71, .h = 68,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {0, 0, 0, 0},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages",
+		.type = SCENE_PART_IMAGE,
+		.x = 177, .y = 137, .w = 57, .h = 58,
+		.image = "images/icon_unread_messages.png",
+		.pressed_image = "images/icon_unread_messages_pressed.png",
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = true,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages_badge",
+		.type = SCENE_PART_IMAGE,
+		.x = 216, .y = 127, .w = 32, .h = 30,
+		.image = "images/badge.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "unread_messages_badge_counter",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 216, .y = 127, .w = 32, .h = 30,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=18 align=center color=#ffffffff style=shadow,bottom shadow_color=#999999ff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "steps",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 77, .y = 195, .w = 57, .h = 23,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=16 align=center color=#ffffffff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "heart_rate",
+		.type = SCENE_PART_TEXTBLOCK,
+		.x = 177, .y = 195, .w = 57, .h = 23,
+		.image = NULL,
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = "font=default font_size=16 align=center color=#ffffffff",
+		.visible = false,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "hands_center",
+		.type = SCENE_PART_IMAGE,
+		.x = 152, .y = 152, .w = 16, .h = 16,
+		.image = "images/hands_center.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = false,
+		.center_x = 0, .center_y = 0,
+	},
+	{
+		.name = "hand_hour",
+		.type = SCENE_PART_IMAGE,
+		.x = 157, .y = 84, .w = 10, .h = 76,
+		.image = "images/hand_hour.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 160, .center_y = 160,
+	},
+	{
+		.name = "hand_minute",
+		.type = SCENE_PART_IMAGE,
+		.x = 157, .y = 66, .w = 10, .h = 94,
+		.image = "images/hand_minute.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 160, .center_y = 160,
+	},
+	{
+		.name = "hand_second",
+		.type = SCENE_PART_IMAGE,
+		.x = 154, .y = 57, .w = 16, .h = 8,
+		.image = "images/hand_second.png",
+		.pressed_image = NULL,
+		.color = {255, 255, 255, 255},
+		.text_style = NULL,
+		.visible = true,
+		.mouse_events = true,
+		.repeat_events = false,
+		.map_rotation = true,
+		.center_x = 160, .center_y = 160,
+	},
+};
+
+static const scene_counter_t s_counters[] = {
+	{.badge_part = 3, .text_part = 4, .frame_state_idx = FRAME_STATE_IDX_MISSED_CALLS, .dirty_flag = FRAME_STATE_DIRTY_MISSED_CALLS, .max_value = 99},
+	{.badge_part = 7, .text_part = 8, .frame_state_idx = FRAME_STATE_IDX_UNREAD_MESSAGES, .dirty_flag = FRAME_STATE_DIRTY_UNREAD_MESSAGES, .max_value = 99},
+	{.badge_part = -1, .text_part = 9, .frame_state_idx = FRAME_STATE_IDX_STEPS, .dirty_flag = FRAME_STATE_DIRTY_STEPS, .max_value = 0},
+	{.badge_part = -1, .text_part = 10, .frame_state_idx = FRAME_STATE_IDX_HEART_RATE, .dirty_flag = FRAME_STATE_DIRTY_HEART_RATE, .max_value = 0},
+};
+
+const scene_t scene_main[] = {
+	{
+		.width = 360,
+		.height = 360,
+		.parts = s_parts_360x360,
+		.part_count = sizeof(s_parts_360x360) / sizeof(s_parts_360x360[0]),
+		.counters = s_counters,
+		.counter_count = sizeof(s_counters) / sizeof(s_counters[0]),
+	},
+	{
+		.width = 320,
+		.height = 320,
+		.parts = s_parts_320x320,
+		.part_count = sizeof(s_parts_320x320) / sizeof(s_parts_320x320[0]),
+		.counters = s_counters,
+		.counter_count = sizeof(s_counters) / sizeof(s_counters[0]),
+	},
+};
+
+const int scene_main_count = sizeof(scene_main) / sizeof(scene_main[0]);
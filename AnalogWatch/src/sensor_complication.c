@@ -0,0 +1,666 @@
+/*
+ * Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <Elementary.h>
+#if !defined(SENSOR_REPLAY)
+#include <sensor.h>
+#endif
+#include "analogwatch.h"
+#include "view.h"
+#include "sensor_complication.h"
+#include "energy.h"
+#include "memory_accounting.h"
+
+/*
+ * Readings are delivered by the sensor FIFO in batches and are only stored by the event callback.
+ * The view is updated from sensor_complication_tick(), so the display changes at most once per
+ * app_time_tick (once per second) or app_ambient_tick (once per minute).
+ */
+#define SENSOR_PEDOMETER_INTERVAL_MS 1000
+#define SENSOR_PEDOMETER_AMBIENT_INTERVAL_MS 10000
+#define SENSOR_HRM_INTERVAL_MS 5000
+#define SENSOR_HRM_AMBIENT_INTERVAL_MS 30000
+#define SENSOR_BATCH_LATENCY_MS 10000
+#define SENSOR_AMBIENT_BATCH_LATENCY_MS 60000
+#define WAKEUP_REPORT_PERIOD 600.0
+
+#if !defined(SENSOR_REPLAY) && !SENSOR_PEDOMETER_SUPPORTED
+/*
+ * Without the pedometer the steps are detected in the accelerometer readings. A step is counted when
+ * the magnitude of the acceleration rises above the high threshold after it has fallen below the low
+ * one, at most once per STEP_MIN_INTERVAL_US. The thresholds are compared squared (in (m/s^2)^2).
+ */
+#define STEP_SAMPLING_INTERVAL_MS 50
+#define STEP_THRESHOLD_HIGH_SQ (11.5f * 11.5f)
+#define STEP_THRESHOLD_LOW_SQ (10.3f * 10.3f)
+#define STEP_MIN_INTERVAL_US 250000ULL
+#endif
+
+#if defined(SENSOR_REPLAY)
+#define SENSOR_REPLAY_FILE "sensor_replay.csv"
+#define SENSOR_REPLAY_INTERVAL_MS 5000
+#define SENSOR_REPLAY_MAX_SAMPLES 4096
+#define SENSOR_REPLAY_BUFFER_BYTES (SENSOR_REPLAY_MAX_SAMPLES * sizeof(struct _replay_sample))
+#endif
+
+typedef enum {SENSOR_ID_STEPS, SENSOR_ID_HEART_RATE, SENSOR_ID_MAX} sensor_id_t;
+
+/*
+ * The wakeups are counted by the energy accounting, the report only keeps the counters
+ * at the beginning of the period.
+ */
+struct _wakeup_stats {
+	double period_start;
+	double ticks;
+	double sensor;
+};
+
+#if defined(SENSOR_REPLAY)
+struct _replay_sample {
+	unsigned int offset_ms;
+	sensor_id_t id;
+	int value;
+};
+#else
+struct _sensor_config {
+	sensor_type_e type;
+	unsigned int interval_ms;
+	unsigned int ambient_interval_ms;
+	sensor_option_e option;
+};
+#endif
+
+#if !defined(SENSOR_REPLAY) && !SENSOR_PEDOMETER_SUPPORTED
+struct _step_detector {
+	bool above_low;
+	unsigned long long last_step;
+	int steps;
+};
+#endif
+
+static struct sensor_complication_info {
+	bool running;
+	size_t memory_size;
+	bool ambient_mode;
+	int values[SENSOR_ID_MAX];
+	int shown_values[SENSOR_ID_MAX];
+	struct _wakeup_stats wakeups;
+#if defined(SENSOR_REPLAY)
+	struct _replay_sample *samples;
+	int sample_count;
+	int next_sample;
+	double replay_start;
+	Ecore_Timer *replay_timer;
+#else
+	sensor_listener_h listeners[SENSOR_ID_MAX];
+#endif
+#if !defined(SENSOR_REPLAY) && !SENSOR_PEDOMETER_SUPPORTED
+	struct _step_detector step_detector;
+#endif
+} s_info = {
+	.running = false,
+	.memory_size = 0,
+	.ambient_mode = false,
+};
+
+#if !defined(SENSOR_REPLAY)
+/*
+ * The steps source keeps running while the display is off, otherwise the steps would be missed,
+ * and its readings wait in the FIFO. The heart rate monitor uses the default option, so it is paused
+ * while the display is off, and it is sampled every few seconds only.
+ */
+static const struct _sensor_config s_sensor_configs[SENSOR_ID_MAX] = {
+#if SENSOR_PEDOMETER_SUPPORTED
+	[SENSOR_ID_STEPS] = {SENSOR_HUMAN_PEDOMETER, SENSOR_PEDOMETER_INTERVAL_MS, SENSOR_PEDOMETER_AMBIENT_INTERVAL_MS, SENSOR_OPTION_ALWAYS_ON},
+#else
+	[SENSOR_ID_STEPS] = {SENSOR_ACCELEROMETER, STEP_SAMPLING_INTERVAL_MS, STEP_SAMPLING_INTERVAL_MS, SENSOR_OPTION_ALWAYS_ON},
+#endif
+	[SENSOR_ID_HEART_RATE] = {SENSOR_HRM, SENSOR_HRM_INTERVAL_MS, SENSOR_HRM_AMBIENT_INTERVAL_MS, SENSOR_OPTION_DEFAULT},
+};
+#endif
+
+static void _store_reading(sensor_id_t id, int value);
+static void _wakeup_get(double *ticks, double *sensor);
+static void _wakeup_report(void);
+static unsigned int _batch_latency_get(void);
+static void _memory_evict_cb(void *data);
+#if defined(SENSOR_REPLAY)
+static double _replay_interval_get(void);
+static bool _replay_load(void);
+static void _replay_deliver(void);
+static Eina_Bool _replay_timer_cb(void *data);
+#else
+static unsigned int _interval_get(sensor_id_t id);
+static sensor_listener_h _create_listener(sensor_id_t id);
+static void _sensor_event_cb(sensor_h sensor, sensor_event_s *event, void *data);
+#if !SENSOR_PEDOMETER_SUPPORTED
+static void _detect_step(sensor_event_s *event);
+#endif
+#endif
+
+/*
+ * @brief Starts the delivery of the steps and heart rate readings.
+ * @return: The function returns 'true' if at least one of the sensors is started, otherwise 'false' is returned.
+ */
+bool sensor_complication_create(void)
+{
+	size_t memory_size = 0;
+
+#if defined(SENSOR_REPLAY)
+	if (_replay_load()) {
+		s_info.replay_start = ecore_time_get();
+		s_info.replay_timer = ecore_timer_add(_replay_interval_get(), _replay_timer_cb, NULL);
+		if (s_info.replay_timer)
+			s_info.running = true;
+		else
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to start the sensor replay.");
+	}
+#else
+	size_t rss_before = memory_get_rss();
+	size_t rss_after;
+	int i;
+
+	for (i = 0; i < SENSOR_ID_MAX; i++) {
+		s_info.listeners[i] = _create_listener(i);
+		if (s_info.listeners[i])
+			s_info.running = true;
+	}
+
+	/*
+	 * The listeners are allocated by the sensor framework, so their size is measured as the growth
+	 * of the resident set while they are created.
+	 */
+	rss_after = memory_get_rss();
+	if (rss_after > rss_before)
+		memory_size = rss_after - rss_before;
+#endif
+
+	if (!s_info.running) {
+		sensor_complication_destroy();
+		return false;
+	}
+
+	/*
+	 * The complication is an optional asset, so it is stopped if it does not fit into the memory budget.
+	 * The replay buffer is reserved by itself while the readings are loaded.
+	 */
+	if (!memory_reserve_optional(MEMORY_SUBSYSTEM_SENSORS, memory_size)) {
+		sensor_complication_destroy();
+		return false;
+	}
+
+	s_info.memory_size = memory_size;
+
+	/*
+	 * The eviction callback is set once the complication is started, so it never stops
+	 * the complication which is being created.
+	 */
+	memory_set_evict_cb(MEMORY_SUBSYSTEM_SENSORS, _memory_evict_cb, NULL);
+
+	return true;
+}
+
+/*
+ * @brief Adjusts the sampling interval and the FIFO batch latency to the ambient mode.
+ * @param[ambient_mode]: the current ambient mode.
+ */
+void sensor_complication_set_ambient_mode(bool ambient_mode)
+{
+	s_info.ambient_mode = ambient_mode;
+
+	if (!s_info.running)
+		return;
+
+#if defined(SENSOR_REPLAY)
+	ecore_timer_interval_set(s_info.replay_timer, _replay_interval_get());
+#else
+	int i;
+
+	for (i = 0; i < SENSOR_ID_MAX; i++) {
+		if (!s_info.listeners[i])
+			continue;
+
+		sensor_listener_set_interval(s_info.listeners[i], _interval_get(i));
+
+		if (sensor_listener_set_max_batch_latency(s_info.listeners[i], _batch_latency_get()) != SENSOR_ERROR_NONE)
+			dlog_print(DLOG_WARN, LOG_TAG, "sensor_listener_set_max_batch_latency() is failed.");
+	}
+#endif
+}
+
+/*
+ * @brief Passes the readings changed since the previous tick to the view. This function must be
+ * called from the time tick callbacks. Wakeups per hour are reported from here as well.
+ */
+void sensor_complication_tick(void)
+{
+	if (s_info.values[SENSOR_ID_STEPS] != s_info.shown_values[SENSOR_ID_STEPS]) {
+		s_info.shown_values[SENSOR_ID_STEPS] = s_info.values[SENSOR_ID_STEPS];
+		view_set_steps(s_info.values[SENSOR_ID_STEPS]);
+	}
+
+	if (s_info.values[SENSOR_ID_HEART_RATE] != s_info.shown_values[SENSOR_ID_HEART_RATE]) {
+		s_info.shown_values[SENSOR_ID_HEART_RATE] = s_info.values[SENSOR_ID_HEART_RATE];
+		view_set_heart_rate(s_info.values[SENSOR_ID_HEART_RATE]);
+	}
+
+	_wakeup_report();
+}
+
+/*
+ * @brief Delivers the latest readings at once, as the FIFO flush does. The energy benchmark calls it
+ * in order to drive the sensor source on the simulated schedule of the batches.
+ */
+void sensor_complication_flush(void)
+{
+	if (!s_info.running)
+		return;
+
+#if defined(SENSOR_REPLAY)
+	/*
+	 * The replay clock is moved on by one flush interval, so each flush delivers the readings of the next batch.
+	 */
+	s_info.replay_start -= _replay_interval_get();
+	_replay_deliver();
+#else
+	sensor_event_s event;
+	int i;
+
+	for (i = 0; i < SENSOR_ID_MAX; i++) {
+		if (!s_info.listeners[i])
+			continue;
+
+		if (sensor_listener_read_data(s_info.listeners[i], &event) == SENSOR_ERROR_NONE)
+			_sensor_event_cb(NULL, &event, (void *)(intptr_t)i);
+	}
+#endif
+}
+
+/*
+ * @brief Stops the delivery of the readings and releases the sensors.
+ */
+void sensor_complication_destroy(void)
+{
+#if defined(SENSOR_REPLAY)
+	if (s_info.replay_timer) {
+		ecore_timer_del(s_info.replay_timer);
+		s_info.replay_timer = NULL;
+	}
+
+	if (s_info.samples) {
+		free(s_info.samples);
+		memory_release(MEMORY_SUBSYSTEM_SENSORS, SENSOR_REPLAY_BUFFER_BYTES);
+	}
+
+	s_info.samples = NULL;
+	s_info.sample_count = 0;
+#else
+	int i;
+
+	for (i = 0; i < SENSOR_ID_MAX; i++) {
+		if (!s_info.listeners[i])
+			continue;
+
+		sensor_listener_stop(s_info.listeners[i]);
+		sensor_destroy_listener(s_info.listeners[i]);
+		s_info.listeners[i] = NULL;
+	}
+#endif
+
+	memory_set_evict_cb(MEMORY_SUBSYSTEM_SENSORS, NULL, NULL);
+	memory_release(MEMORY_SUBSYSTEM_SENSORS, s_info.memory_size);
+	s_info.memory_size = 0;
+
+	s_info.running = false;
+}
+
+/*
+ * @brief Stores the reading until the next tick.
+ * @param[id]: the sensor the reading comes from.
+ * @param[value]: the number of steps or the heart rate in beats per minute.
+ */
+static void _store_reading(sensor_id_t id, int value)
+{
+	energy_begin(ENERGY_SOURCE_SENSOR);
+
+	s_info.values[id] = value;
+
+	energy_end();
+}
+
+/*
+ * @brief Gets the number of wakeups counted by the energy accounting. All the callbacks invoked within
+ * one main loop iteration (e.g. a batch of sensor events delivered together with the time tick) are
+ * counted as a single wakeup of the source which has been handled first.
+ * @param[ticks]: the number of wakeups by the time ticks.
+ * @param[sensor]: the number of wakeups by the sensor delivery.
+ */
+static void _wakeup_get(double *ticks, double *sensor)
+{
+	*ticks = energy_get_wakeups(ENERGY_SOURCE_TIME_TICK) + energy_get_wakeups(ENERGY_SOURCE_AMBIENT_TICK);
+	*sensor = energy_get_wakeups(ENERGY_SOURCE_SENSOR);
+}
+
+/*
+ * @brief Logs the number of wakeups per hour once per WAKEUP_REPORT_PERIOD.
+ */
+static void _wakeup_report(void)
+{
+	double now = ecore_time_get();
+	double elapsed = now - s_info.wakeups.period_start;
+	double ticks, sensor;
+
+	_wakeup_get(&ticks, &sensor);
+
+	if (s_info.wakeups.period_start == 0.0) {
+		s_info.wakeups.period_start = now;
+		s_info.wakeups.ticks = ticks;
+		s_info.wakeups.sensor = sensor;
+		return;
+	}
+
+	if (elapsed < WAKEUP_REPORT_PERIOD)
+		return;
+
+	ticks -= s_info.wakeups.ticks;
+	sensor -= s_info.wakeups.sensor;
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "wakeups: %.0f/h (ticks %.0f/h, sensors %.0f/h), sensor complication %s",
+			(ticks + sensor) * 3600.0 / elapsed,
+			ticks * 3600.0 / elapsed,
+			sensor * 3600.0 / elapsed,
+			s_info.running ? "on" : "off");
+
+	s_info.wakeups.period_start = now;
+	s_info.wakeups.ticks += ticks;
+	s_info.wakeups.sensor += sensor;
+}
+
+/*
+ * @brief Gets the maximum time the readings may be kept in the sensor FIFO.
+ * @return: The batch latency in milliseconds for the current ambient mode or 0 if the batching is disabled.
+ */
+static unsigned int _batch_latency_get(void)
+{
+	if (!SENSOR_BATCHING_ENABLED)
+		return 0;
+
+	return s_info.ambient_mode ? SENSOR_AMBIENT_BATCH_LATENCY_MS : SENSOR_BATCH_LATENCY_MS;
+}
+
+#if defined(SENSOR_REPLAY)
+/*
+ * @brief Gets the interval of the replayed FIFO flushes. Without the batching every recorded reading is
+ * delivered on its own, i.e. the flushes follow the sampling period of the recording.
+ * @return: The interval in seconds.
+ */
+static double _replay_interval_get(void)
+{
+	unsigned int latency = _batch_latency_get();
+
+	return (latency > 0 ? latency : SENSOR_REPLAY_INTERVAL_MS) / 1000.0;
+}
+#endif
+
+/*
+ * @brief The callback function invoked when the memory budget is exceeded. The complication is
+ * stopped, which releases the listeners or the replay buffer, and hidden at once, which releases
+ * the glyphs of its digits on the next frame.
+ * @param[data]: the user data passed to the memory_set_evict_cb() function.
+ */
+static void _memory_evict_cb(void *data)
+{
+	int i;
+
+	sensor_complication_destroy();
+
+	for (i = 0; i < SENSOR_ID_MAX; i++) {
+		s_info.values[i] = 0;
+		s_info.shown_values[i] = 0;
+	}
+
+	view_set_steps(0);
+	view_set_heart_rate(0);
+}
+
+#if defined(SENSOR_REPLAY)
+/*
+ * @brief Loads the recorded readings from the resource directory. Each line of the file has
+ * the form '<offset_ms>,<steps|heart_rate>,<value>'. Empty lines and lines starting with '#' are skipped.
+ * @return: The function returns 'true' if at least one reading is loaded, otherwise 'false' is returned.
+ */
+static bool _replay_load(void)
+{
+	char path[PATH_MAX] = {0,};
+	char line[128] = {0,};
+	char name[32] = {0,};
+	char *res_path = NULL;
+	FILE *file = NULL;
+	struct _replay_sample sample;
+
+	res_path = app_get_resource_path();
+	if (!res_path) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to get resource path.");
+		return false;
+	}
+
+	snprintf(path, sizeof(path), "%s%s", res_path, SENSOR_REPLAY_FILE);
+	free(res_path);
+
+	file = fopen(path, "r");
+	if (!file) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to open '%s'.", path);
+		return false;
+	}
+
+	/*
+	 * The replay buffer is a part of the optional complication, so it is not allocated if it does
+	 * not fit into the memory budget.
+	 */
+	if (!memory_reserve_optional(MEMORY_SUBSYSTEM_SENSORS, SENSOR_REPLAY_BUFFER_BYTES)) {
+		dlog_print(DLOG_WARN, LOG_TAG, "the sensor replay buffer does not fit into the memory budget.");
+		fclose(file);
+		return false;
+	}
+
+	s_info.samples = calloc(SENSOR_REPLAY_MAX_SAMPLES, sizeof(struct _replay_sample));
+	if (!s_info.samples) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to allocate the sensor replay buffer.");
+		memory_release(MEMORY_SUBSYSTEM_SENSORS, SENSOR_REPLAY_BUFFER_BYTES);
+		fclose(file);
+		return false;
+	}
+
+	while (s_info.sample_count < SENSOR_REPLAY_MAX_SAMPLES && fgets(line, sizeof(line), file)) {
+		if (line[0] == '#' || line[0] == '\n')
+			continue;
+
+		if (sscanf(line, "%u,%31[a-z_],%d", &sample.offset_ms, name, &sample.value) != 3) {
+			dlog_print(DLOG_WARN, LOG_TAG, "invalid sensor replay line: %s", line);
+			continue;
+		}
+
+		if (strcmp(name, "steps") == 0)
+			sample.id = SENSOR_ID_STEPS;
+		else if (strcmp(name, "heart_rate") == 0)
+			sample.id = SENSOR_ID_HEART_RATE;
+		else
+			continue;
+
+		s_info.samples[s_info.sample_count++] = sample;
+	}
+
+	fclose(file);
+
+	return s_info.sample_count > 0;
+}
+
+/*
+ * @brief Delivers all the recorded readings due since the previous delivery at once.
+ * The recording is replayed in a loop.
+ */
+static void _replay_deliver(void)
+{
+	unsigned int elapsed_ms = (unsigned int)((ecore_time_get() - s_info.replay_start) * 1000.0);
+	struct _replay_sample *sample = NULL;
+
+	while (s_info.next_sample < s_info.sample_count) {
+		sample = &s_info.samples[s_info.next_sample];
+		if (sample->offset_ms > elapsed_ms)
+			break;
+
+		_store_reading(sample->id, sample->value);
+		s_info.next_sample++;
+	}
+
+	if (s_info.next_sample == s_info.sample_count) {
+		s_info.next_sample = 0;
+		s_info.replay_start = ecore_time_get();
+	}
+}
+
+/*
+ * @brief The timer callback which stands in for the sensor FIFO flush.
+ * @param[data]: the user data passed to the ecore_timer_add function.
+ * @return: ECORE_CALLBACK_RENEW to keep the replay running.
+ */
+static Eina_Bool _replay_timer_cb(void *data)
+{
+	_replay_deliver();
+
+	return ECORE_CALLBACK_RENEW;
+}
+#else
+/*
+ * @brief Gets the sampling interval of the given sensor.
+ * @param[id]: the sensor.
+ * @return: The interval in milliseconds for the current ambient mode.
+ */
+static unsigned int _interval_get(sensor_id_t id)
+{
+	return s_info.ambient_mode ? s_sensor_configs[id].ambient_interval_ms : s_sensor_configs[id].interval_ms;
+}
+
+/*
+ * @brief Creates and starts the batched listener of the given sensor.
+ * @param[id]: the sensor to be listened to.
+ * @return: The listener started or NULL if the sensor is not available.
+ */
+static sensor_listener_h _create_listener(sensor_id_t id)
+{
+	sensor_h sensor = NULL;
+	sensor_listener_h listener = NULL;
+	const struct _sensor_config *config = &s_sensor_configs[id];
+	bool supported = false;
+
+	if (sensor_is_supported(config->type, &supported) != SENSOR_ERROR_NONE || !supported) {
+		dlog_print(DLOG_WARN, LOG_TAG, "sensor %d is not supported.", config->type);
+		return NULL;
+	}
+
+	if (sensor_get_default_sensor(config->type, &sensor) != SENSOR_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "sensor_get_default_sensor() is failed.");
+		return NULL;
+	}
+
+	if (sensor_create_listener(sensor, &listener) != SENSOR_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "sensor_create_listener() is failed.");
+		return NULL;
+	}
+
+	if (sensor_listener_set_event_cb(listener, _interval_get(id), _sensor_event_cb, (void *)(intptr_t)id) != SENSOR_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "sensor_listener_set_event_cb() is failed.");
+		sensor_destroy_listener(listener);
+		return NULL;
+	}
+
+	/*
+	 * Without the batch latency set every reading wakes the application up.
+	 * The listener still works in that case, so the failure is not fatal.
+	 */
+	if (sensor_listener_set_max_batch_latency(listener, _batch_latency_get()) != SENSOR_ERROR_NONE)
+		dlog_print(DLOG_WARN, LOG_TAG, "sensor_listener_set_max_batch_latency() is failed.");
+
+	if (sensor_listener_set_option(listener, config->option) != SENSOR_ERROR_NONE)
+		dlog_print(DLOG_WARN, LOG_TAG, "sensor_listener_set_option() is failed.");
+
+	if (sensor_listener_start(listener) != SENSOR_ERROR_NONE) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "sensor_listener_start() is failed.");
+		sensor_destroy_listener(listener);
+		return NULL;
+	}
+
+	return listener;
+}
+
+/*
+ * @brief The callback function invoked for each reading delivered from the sensor FIFO.
+ * @param[sensor]: the sensor handle.
+ * @param[event]: the sensor reading. The first value is the number of steps or the heart rate,
+ * the accelerometer readings are passed to the step detection.
+ * @param[data]: the sensor identifier passed to the sensor_listener_set_event_cb() function.
+ */
+static void _sensor_event_cb(sensor_h sensor, sensor_event_s *event, void *data)
+{
+	sensor_id_t id = (sensor_id_t)(intptr_t)data;
+
+	if (!event || event->value_count < 1)
+		return;
+
+#if !SENSOR_PEDOMETER_SUPPORTED
+	if (id == SENSOR_ID_STEPS) {
+		_detect_step(event);
+		return;
+	}
+#endif
+
+	_store_reading(id, (int)event->values[0]);
+}
+
+#if !SENSOR_PEDOMETER_SUPPORTED
+/*
+ * @brief Counts a step if the accelerometer reading completes a peak of the acceleration's magnitude.
+ * @param[event]: the accelerometer reading in m/s^2 with the timestamp in microseconds.
+ */
+static void _detect_step(sensor_event_s *event)
+{
+	struct _step_detector *detector = &s_info.step_detector;
+	float magnitude_sq;
+
+	if (event->value_count < 3)
+		return;
+
+	magnitude_sq = event->values[0] * event->values[0] + event->values[1] * event->values[1] + event->values[2] * event->values[2];
+
+	if (magnitude_sq < STEP_THRESHOLD_LOW_SQ) {
+		detector->above_low = false;
+		return;
+	}
+
+	if (detector->above_low || magnitude_sq < STEP_THRESHOLD_HIGH_SQ)
+		return;
+
+	detector->above_low = true;
+
+	if (detector->last_step > 0 && event->timestamp - detector->last_step < STEP_MIN_INTERVAL_US)
+		return;
+
+	detector->last_step = event->timestamp;
+
+	_store_reading(SENSOR_ID_STEPS, ++detector->steps);
+}
+#endif
+#endif
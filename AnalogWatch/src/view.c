@@ -18,60 +18,252 @@
 #include "analogwatch.h"
 #include "view.h"
 #include "view_defines.h"
+#include "energy.h"
+#include "memory_accounting.h"
+#include "memory_budget.h"
+#include "scene.h"
+#include "asset_store.h"
 
 #define MAIN_EDJ "edje/main.edj"
+#define STATS_REPORT_PERIOD 1.0
+#define TOUCH_STATS_REPORT_TAPS 10
+
+/*
+ * The font sizes of the 'badge_style' and the 'complication_style' text styles and the largest
+ * badge counter displayed as a number, as defined in main.edc.
+ */
+#define BADGE_FONT_SIZE 18
+#define COMPLICATION_FONT_SIZE 16
+#define BADGE_MAX_VALUE 99
+#define GLYPH_PLUS (1 << 10)
+#define FRAME_STATE_DIRTY_TEXT (FRAME_STATE_DIRTY_MISSED_CALLS | FRAME_STATE_DIRTY_UNREAD_MESSAGES | \
+		FRAME_STATE_DIRTY_STEPS | FRAME_STATE_DIRTY_HEART_RATE)
+
+#if defined(VIEW_TAP_BENCHMARK)
+#define TAP_BENCHMARK_TAPS 200
+#define TAP_BENCHMARK_INTERVAL 0.05
+#endif
+
+#if defined(VIEW_FRAME_BENCHMARK)
+#define FRAME_BENCHMARK_ITERATIONS 200
+#define FRAME_BENCHMARK_INTERVAL 0.05
+#endif
+
+struct _frame_state {
+	int version;
+	int dirty;
+	current_time_t time;
+	bool ambient_mode;
+	int missed_calls;
+	int unread_messages;
+	int steps;
+	int heart_rate;
+	energy_source_t source;
+};
+
+struct _frame_stats {
+	double period_start;
+	int changes;
+	int messages;
+	int recalcs;
+	double flush_time;
+	int frames;
+	double frame_time_sum;
+	int total_changes;
+	int total_messages;
+	int total_recalcs;
+	int total_frames;
+	double total_frame_time_sum;
+};
+
+/*
+ * The frame is rendered after the frame state flush, possibly in a later main loop iteration,
+ * so the source of the event which has changed the frame is kept until the frame is rendered.
+ */
+struct _render_info {
+	bool pending;
+	energy_source_t source;
+	double start;
+};
+
+struct _startup_info {
+	double start;
+	double view_created;
+	bool first_frame;
+};
+
+struct _latency_stats {
+	int count;
+	double sum;
+	double min;
+	double max;
+};
+
+struct _touch_info {
+	double event_time;
+	double down_time;
+	double up_time;
+	bool feedback_pending;
+	struct _latency_stats feedback;
+	struct _latency_stats launch;
+};
 
 static struct view_info {
 	Evas_Object *win;
 	Evas_Object *layout;
+	const scene_t *scene;
 	int w;
 	int h;
 	icon_pressed_cb icon_pressed_cb;
+	struct _frame_state frame;
+	Ecore_Job *frame_job;
+	struct _frame_stats stats;
+	struct _render_info render;
+	struct _touch_info touch;
+	struct _startup_info startup;
+	bool font_cache_flush;
+	size_t images_size;
+#if defined(VIEW_TAP_BENCHMARK)
+	int benchmark_events;
+#endif
+#if defined(VIEW_FRAME_BENCHMARK)
+	int benchmark_iterations;
+#endif
 } s_info = {
 	.win = NULL,
 	.layout = NULL,
+	.scene = NULL,
 	.w = 0,
 	.h = 0,
+	.frame = {
+		.version = FRAME_STATE_VERSION,
+		.dirty = 0,
+	},
+	.frame_job = NULL,
 };
 
 static char *_create_resource_path(const char *file_name);
 static Evas_Object *_create_layout(void);
-static void _emit_signal(Evas_Object *layout, const char *target_part, const char *signal_name);
-static void _set_badge(int message_id, int badge_count);
+#if defined(VIEW_NATIVE_SCENE)
+static const scene_t *_create_scene(void);
+#endif
+static Evas_Object *_part_object_get(const char *part_name);
+static void _frame_state_mark_dirty(int dirty_flag);
+static void _frame_state_flush_cb(void *data);
+static void _frame_state_send(void);
+static void _stats_update(void);
+static void _layout_recalc_cb(void *data, Evas_Object *obj, void *event_info);
+static void _layout_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+static bool _is_inside_part(const char *part_name, Evas_Coord x, Evas_Coord y);
+static void _touch_begin(void);
+static void _touch_end(view_icon_id_t id);
+static void _latency_stats_add(struct _latency_stats *stats, double latency);
+static void _touch_stats_report(void);
+static void _render_expect(energy_source_t source);
+static void _render_pre_cb(void *data, Evas *e, void *event_info);
+static void _render_post_cb(void *data, Evas *e, void *event_info);
+static unsigned long long _get_decoded_parts_size(const char **parts, int count);
+static void _account_decoded_images(energy_source_t source);
+static void _account_images(void);
+static unsigned int _glyphs_add(unsigned int glyphs, int value, bool capped);
+static void _account_text(void);
+static void _memory_exceeded(void);
+#if defined(VIEW_TAP_BENCHMARK)
+static Eina_Bool _tap_benchmark_cb(void *data);
+#endif
+#if defined(VIEW_FRAME_BENCHMARK)
+static Eina_Bool _frame_benchmark_cb(void *data);
+#endif
 static void _missed_calls_mouse_down_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _missed_calls_mouse_up_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _unread_messages_mouse_down_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
 static void _unread_messages_mouse_up_cb(void *data, Evas_Object *obj, const char *emission, const char *source);
+#if defined(VIEW_NATIVE_SCENE)
+static void _icon_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+static void _icon_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info);
+#endif
 
 /*
  * @brief Creates the application's UI with window's width and height preset.
+ * @return: The function returns 'true' if the UI is created, otherwise 'false' is returned.
  */
-void view_create_with_size(int width, int height)
+bool view_create_with_size(int width, int height)
 {
 	s_info.w = width;
 	s_info.h = height;
 
-	view_create();
+	return view_create();
 }
 
 /*
  * @brief Create Essential Object window and layout
+ * @return: The function returns 'true' if the UI is created within the memory budget, otherwise 'false' is returned.
  */
-void view_create(void)
+bool view_create(void)
 {
+	size_t rss_before;
+	size_t rss_after;
+
+	s_info.startup.start = ecore_time_get();
+
 	s_info.win = view_create_win(PACKAGE);
 	if (!s_info.win) {
 		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create a window.");
-		return;
+		return false;
 	}
 
-	s_info.layout = _create_layout();
-	if (!s_info.layout) {
-		dlog_print(DLOG_ERROR, LOG_TAG, "failed to create main layout.");
-		return;
+	/*
+	 * The layout's part tree, programs and script (or the native scene's objects) are allocated
+	 * by the libraries, so its size is measured as the growth of the resident set while the view is created.
+	 */
+	rss_before = memory_get_rss();
+
+#if defined(VIEW_NATIVE_SCENE)
+	s_info.scene = _create_scene();
+	if (!s_info.scene)
+		dlog_print(DLOG_WARN, LOG_TAG, "no native scene for %dx%d, the EDJE layout is used.", s_info.w, s_info.h);
+#endif
+
+	if (!s_info.scene) {
+		s_info.layout = _create_layout();
+		if (!s_info.layout) {
+			dlog_print(DLOG_ERROR, LOG_TAG, "failed to create main layout.");
+			return false;
+		}
+	}
+
+	rss_after = memory_get_rss();
+	if (!memory_reserve(MEMORY_SUBSYSTEM_LAYOUT, rss_after > rss_before ? rss_after - rss_before : 0)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "the layout does not fit into the memory budget.");
+		scene_destroy();
+		s_info.scene = NULL;
+		if (s_info.layout) {
+			evas_object_del(s_info.layout);
+			s_info.layout = NULL;
+		}
+		return false;
 	}
 
+	s_info.startup.view_created = ecore_time_get();
+
+	_render_expect(ENERGY_SOURCE_STARTUP);
+
+	evas_event_callback_add(evas_object_evas_get(s_info.win), EVAS_CALLBACK_RENDER_PRE, _render_pre_cb, NULL);
+	evas_event_callback_add(evas_object_evas_get(s_info.win), EVAS_CALLBACK_RENDER_POST, _render_post_cb, NULL);
+
+#if defined(VIEW_TAP_BENCHMARK)
+	if (!ecore_timer_add(TAP_BENCHMARK_INTERVAL, _tap_benchmark_cb, NULL))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to start the tap benchmark.");
+#endif
+
+#if defined(VIEW_FRAME_BENCHMARK)
+	if (!ecore_timer_add(FRAME_BENCHMARK_INTERVAL, _frame_benchmark_cb, NULL))
+		dlog_print(DLOG_ERROR, LOG_TAG, "failed to start the frame benchmark.");
+#endif
+
 	evas_object_show(s_info.win);
+
+	return true;
 }
 
 /*
@@ -102,6 +294,19 @@ Evas_Object *view_create_win(const char *pkg_name)
 
 	evas_object_resize(win, s_info.w, s_info.h);
 
+	/*
+	 * The window's surface is accounted to the view, and the face is not created if it does not fit.
+	 * The decoded images and glyphs which are not displayed are kept in the canvas caches, which are
+	 * capped so that they cannot grow beyond the budget.
+	 */
+	if (!memory_reserve(MEMORY_SUBSYSTEM_VIEW, (size_t)s_info.w * s_info.h * 4)) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "the window surface does not fit into the memory budget.");
+		return NULL;
+	}
+
+	evas_image_cache_set(evas_object_evas_get(win), MEMORY_IMAGE_CACHE_BYTES);
+	evas_font_cache_set(evas_object_evas_get(win), MEMORY_FONT_CACHE_BYTES);
+
 	return win;
 }
 
@@ -138,16 +343,9 @@ Evas_Object *view_create_layout_for_part(Evas_Object *parent, char *file_path, c
  */
 void view_set_display_time(current_time_t current_time)
 {
-	Edje_Message_Int_Set *msg = malloc(sizeof(Edje_Message_Int_Set) + 2 * sizeof(int));
-
-	msg->count = 3;
-	msg->val[0] = current_time.hour;
-	msg->val[1] = current_time.minute;
-	msg->val[2] = current_time.second;
+	s_info.frame.time = current_time;
 
-	edje_object_message_send(elm_layout_edje_get(s_info.layout), EDJE_MESSAGE_INT_SET, MSG_ID_SET_TIME, msg);
-
-	free(msg);
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_TIME);
 }
 
 /*
@@ -156,11 +354,9 @@ void view_set_display_time(current_time_t current_time)
  */
 void view_toggle_ambient_mode(bool ambient_mode)
 {
-	Edje_Message_Int msg = {0,};
-
-	msg.val = (int)ambient_mode;
+	s_info.frame.ambient_mode = ambient_mode;
 
-	edje_object_message_send(elm_layout_edje_get(s_info.layout), EDJE_MESSAGE_INT, MSG_ID_AMBIENT_MODE, &msg);
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_AMBIENT_MODE);
 }
 
 /*
@@ -169,7 +365,9 @@ void view_toggle_ambient_mode(bool ambient_mode)
  */
 void view_set_bagde_missed_calls(int count)
 {
-	_set_badge(MSG_ID_SET_BADGE_MISSED_CALLS, count);
+	s_info.frame.missed_calls = count;
+
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_MISSED_CALLS);
 }
 
 /*
@@ -178,7 +376,31 @@ void view_set_bagde_missed_calls(int count)
  */
 void view_set_bagde_unread_messages(int count)
 {
-	_set_badge(MSG_ID_SET_BADGE_UNREAD_MESSAGES, count);
+	s_info.frame.unread_messages = count;
+
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_UNREAD_MESSAGES);
+}
+
+/*
+ * @brief Sets the value of the 'steps' complication. The complication is hidden if the count is not positive.
+ * @param[count]: the number of steps to be displayed.
+ */
+void view_set_steps(int count)
+{
+	s_info.frame.steps = count;
+
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_STEPS);
+}
+
+/*
+ * @brief Sets the value of the 'heart rate' complication. The complication is hidden if the rate is not positive.
+ * @param[bpm]: the heart rate in beats per minute to be displayed.
+ */
+void view_set_heart_rate(int bpm)
+{
+	s_info.frame.heart_rate = bpm;
+
+	_frame_state_mark_dirty(FRAME_STATE_DIRTY_HEART_RATE);
 }
 
 /*
@@ -190,11 +412,45 @@ void view_set_icon_pressed_cb(icon_pressed_cb cb)
 	s_info.icon_pressed_cb = cb;
 }
 
+/*
+ * @brief Feeds a simulated mouse down or mouse up event to the centre of the icon, so the event
+ * goes through the same path as a real touch. Used by the benchmarks.
+ * @param[id]: the identifier of the icon.
+ * @param[pressed]: true to feed the mouse down event, false to feed the mouse up event.
+ */
+void view_feed_icon_event(view_icon_id_t id, bool pressed)
+{
+	Evas *evas = evas_object_evas_get(s_info.win);
+	unsigned int timestamp = (unsigned int)(ecore_time_get() * 1000.0);
+	Evas_Coord x, y, w, h;
+
+	if (!evas) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid window object.");
+		return;
+	}
+
+	if (pressed) {
+		evas_object_geometry_get(_part_object_get(id == VIEW_ICON_ID_MISSED_CALLS ? PART_MISSED_CALLS : PART_UNREAD_MESSAGES), &x, &y, &w, &h);
+		evas_event_feed_mouse_move(evas, x + w / 2, y + h / 2, timestamp, NULL);
+		evas_event_feed_mouse_down(evas, 1, EVAS_BUTTON_NONE, timestamp, NULL);
+	} else {
+		evas_event_feed_mouse_up(evas, 1, EVAS_BUTTON_NONE, timestamp, NULL);
+	}
+}
+
 /*
  * @brief Destroys the main window.
  */
 void view_destroy(void)
 {
+	if (s_info.frame_job) {
+		ecore_job_del(s_info.frame_job);
+		s_info.frame_job = NULL;
+	}
+
+	scene_destroy();
+	s_info.scene = NULL;
+
 	if (s_info.win == NULL)
 		return;
 
@@ -242,49 +498,612 @@ static Evas_Object *_create_layout(void)
 	evas_object_resize(layout, s_info.w, s_info.h);
 	evas_object_show(layout);
 
+	/*
+	 * The EDJE signals are delivered after the EDJE programs have switched the pressed state,
+	 * so the moment of the touch is recorded when the canvas dispatches the mouse event.
+	 */
+	evas_object_event_callback_add(elm_layout_edje_get(layout), EVAS_CALLBACK_MOUSE_DOWN, _layout_mouse_down_cb, NULL);
+
 	elm_object_signal_callback_add(layout, "mouse,down,1", PART_MISSED_CALLS, _missed_calls_mouse_down_cb, NULL);
 	elm_object_signal_callback_add(layout, "mouse,up,1", PART_MISSED_CALLS, _missed_calls_mouse_up_cb, NULL);
 	elm_object_signal_callback_add(layout, "mouse,down,1", PART_UNREAD_MESSAGES, _unread_messages_mouse_down_cb, NULL);
 	elm_object_signal_callback_add(layout, "mouse,up,1", PART_UNREAD_MESSAGES, _unread_messages_mouse_up_cb, NULL);
 
+	evas_object_smart_callback_add(elm_layout_edje_get(layout), "recalc", _layout_recalc_cb, NULL);
+
 	return layout;
 }
 
+#if defined(VIEW_NATIVE_SCENE)
 /*
- * @brief Sends a signal to the EDJE script.
- * @param[layout]: the target layout for the signal.
- * @param[target_part]: the target part's name within the layout for the signal.
- * @param[signal_name]: the name of the signal to be sent.
+ * @brief Creates the native scene generated from main.edc for the window's resolution.
+ * @return: The scene created or NULL if there is no scene for the window's resolution.
  */
-static void _emit_signal(Evas_Object *layout, const char *target_part, const char *signal_name)
+static const scene_t *_create_scene(void)
 {
-	if (!layout) {
-		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid input argument.");
+	const scene_t *scene = scene_find(scene_main, scene_main_count, s_info.w, s_info.h);
+	Evas_Object *icon = NULL;
+
+	if (!scene || !scene_create(s_info.win, scene))
+		return NULL;
+
+	icon = scene_part_object_get(PART_MISSED_CALLS);
+	evas_object_event_callback_add(icon, EVAS_CALLBACK_MOUSE_DOWN, _icon_mouse_down_cb, NULL);
+	evas_object_event_callback_add(icon, EVAS_CALLBACK_MOUSE_UP, _icon_mouse_up_cb, (void *)(intptr_t)VIEW_ICON_ID_MISSED_CALLS);
+
+	icon = scene_part_object_get(PART_UNREAD_MESSAGES);
+	evas_object_event_callback_add(icon, EVAS_CALLBACK_MOUSE_DOWN, _icon_mouse_down_cb, NULL);
+	evas_object_event_callback_add(icon, EVAS_CALLBACK_MOUSE_UP, _icon_mouse_up_cb, (void *)(intptr_t)VIEW_ICON_ID_UNREAD_MESSAGES);
+
+	return scene;
+}
+#endif
+
+/*
+ * @brief Gets the canvas object of the part of the layout or of the native scene.
+ * @param[part_name]: the name of the part as defined in main.edc.
+ * @return: The object of the part or NULL if there is no such part.
+ */
+static Evas_Object *_part_object_get(const char *part_name)
+{
+	if (s_info.scene)
+		return scene_part_object_get(part_name);
+
+	if (!s_info.layout)
+		return NULL;
+
+	return (Evas_Object *)edje_object_part_object_get(elm_layout_edje_get(s_info.layout), part_name);
+}
+
+/*
+ * @brief Marks the frame state's field as changed and schedules the frame state to be sent
+ * to the EDJE script at the end of the current main loop iteration. All the changes made
+ * within one iteration are sent with a single message. Building with VIEW_FRAME_STATE_UNBATCHED
+ * defined sends a message per change instead, as a reference for the frame benchmark.
+ * @param[dirty_flag]: one of the FRAME_STATE_DIRTY_* flags.
+ */
+static void _frame_state_mark_dirty(int dirty_flag)
+{
+	s_info.frame.dirty |= dirty_flag;
+	s_info.frame.source = energy_get_source();
+	s_info.stats.changes++;
+	s_info.stats.total_changes++;
+
+#if defined(VIEW_FRAME_STATE_UNBATCHED)
+	_frame_state_send();
+	return;
+#endif
+
+	if (s_info.frame_job)
 		return;
+
+	s_info.frame_job = ecore_job_add(_frame_state_flush_cb, NULL);
+	if (!s_info.frame_job) {
+		dlog_print(DLOG_ERROR, LOG_TAG, "ecore_job_add() is failed.");
+		_frame_state_send();
 	}
+}
+
+/*
+ * @brief The callback function invoked once per main loop iteration in which the frame state has changed.
+ * @param[data]: the user data passed to the ecore_job_add function.
+ */
+static void _frame_state_flush_cb(void *data)
+{
+	s_info.frame_job = NULL;
 
-	elm_object_signal_emit(layout, signal_name, target_part);
+	_frame_state_send();
 }
 
 /*
- * @brief Sends a message to the EDJE script in order to set the badge's value. This function handles the
- * 'missed calls' and the 'unread messages' badges depending on the message_id.
- * @param[message_id]: the message id. Available messages: MSG_ID_SET_BADGE_MISSED_CALLS, MSG_ID_SET_BADGE_UNREAD_MESSAGES.
+ * @brief Sends the collected frame state changes to the EDJE script as the MSG_ID_SET_FRAME_STATE message
+ * or, if the native scene is used, applies them to the scene directly.
  */
-static void _set_badge(int message_id, int badge_count)
+static void _frame_state_send(void)
 {
-	Edje_Message_Int msg = {0,};
+	struct {
+		Edje_Message_Int_Set set;
+		int val[FRAME_STATE_COUNT - 1];
+	} msg;
+	int values[FRAME_STATE_COUNT];
+	double start;
 
-	if (!s_info.layout) {
+	if (!s_info.frame.dirty)
+		return;
+
+	start = ecore_time_get();
+
+	if (!s_info.layout && !s_info.scene) {
 		dlog_print(DLOG_ERROR, LOG_TAG, "Invalid layout object.");
 		return;
 	}
 
-	msg.val = badge_count;
+	values[FRAME_STATE_IDX_VERSION] = s_info.frame.version;
+	values[FRAME_STATE_IDX_DIRTY] = s_info.frame.dirty;
+	values[FRAME_STATE_IDX_HOUR] = s_info.frame.time.hour;
+	values[FRAME_STATE_IDX_MINUTE] = s_info.frame.time.minute;
+	values[FRAME_STATE_IDX_SECOND] = s_info.frame.time.second;
+	values[FRAME_STATE_IDX_AMBIENT_MODE] = (int)s_info.frame.ambient_mode;
+	values[FRAME_STATE_IDX_MISSED_CALLS] = s_info.frame.missed_calls;
+	values[FRAME_STATE_IDX_UNREAD_MESSAGES] = s_info.frame.unread_messages;
+	values[FRAME_STATE_IDX_STEPS] = s_info.frame.steps;
+	values[FRAME_STATE_IDX_HEART_RATE] = s_info.frame.heart_rate;
+
+	if (s_info.scene) {
+		scene_apply_frame_state(values, s_info.frame.dirty);
+		s_info.stats.recalcs++;
+		s_info.stats.total_recalcs++;
+	} else {
+		/*
+		 * The message is copied by edje_object_message_send(), so it is built on the stack.
+		 */
+		msg.set.count = FRAME_STATE_COUNT;
+		memcpy(msg.set.val, values, sizeof(values));
+
+		edje_object_message_send(elm_layout_edje_get(s_info.layout), EDJE_MESSAGE_INT_SET, MSG_ID_SET_FRAME_STATE, &msg.set);
+	}
+
+	if (s_info.frame.dirty & FRAME_STATE_DIRTY_TEXT)
+		_account_text();
+
+	if (s_info.startup.first_frame)
+		_account_images();
+
+	s_info.frame.dirty = 0;
+	s_info.stats.messages++;
+	s_info.stats.total_messages++;
+	s_info.stats.flush_time = ecore_time_get();
+
+	energy_account_message(s_info.frame.source);
+	energy_account_busy(s_info.frame.source, s_info.stats.flush_time - start);
+	_render_expect(s_info.frame.source);
+
+	_stats_update();
+}
+
+/*
+ * @brief Logs the number of frame state changes, messages sent to the EDJE script and layout
+ * recalculations per second along with the average time from the frame state flush until the
+ * frame is rendered. The statistics are reported on the message path only, so no additional
+ * wakeups are introduced.
+ */
+static void _stats_update(void)
+{
+	double now = ecore_time_get();
+	double elapsed = now - s_info.stats.period_start;
+
+	if (s_info.stats.period_start == 0.0) {
+		s_info.stats.period_start = now;
+		return;
+	}
+
+	if (elapsed < STATS_REPORT_PERIOD)
+		return;
+
+	dlog_print(DLOG_DEBUG, LOG_TAG, "frame state: %.2f changes/s, %.2f messages/s, %.2f recalcs/s",
+			s_info.stats.changes / elapsed, s_info.stats.messages / elapsed, s_info.stats.recalcs / elapsed);
+
+	if (s_info.stats.frames > 0)
+		dlog_print(DLOG_DEBUG, LOG_TAG, "frame cost (%s): %.2f ms from flush to render",
+				s_info.scene ? "native scene" : "edje", s_info.stats.frame_time_sum * 1000.0 / s_info.stats.frames);
+
+	s_info.stats.period_start = now;
+	s_info.stats.changes = 0;
+	s_info.stats.messages = 0;
+	s_info.stats.recalcs = 0;
+	s_info.stats.frames = 0;
+	s_info.stats.frame_time_sum = 0.0;
+}
+
+/*
+ * @brief The callback function invoked each time the layout's edje object is recalculated.
+ * @param[data]: the user data passed to the evas_object_smart_callback_add function.
+ * @param[obj]: the layout's edje object.
+ * @param[event_info]: not used.
+ */
+static void _layout_recalc_cb(void *data, Evas_Object *obj, void *event_info)
+{
+	s_info.stats.recalcs++;
+	s_info.stats.total_recalcs++;
+}
+
+/*
+ * @brief The callback function invoked when the canvas dispatches the mouse down event to the layout.
+ * The moment of the touch is recorded only if the press lands on the hit area of one of the icons.
+ * @param[data]: the user data passed to the evas_object_event_callback_add function.
+ * @param[e]: the canvas.
+ * @param[obj]: the layout's edje object.
+ * @param[event_info]: the Evas_Event_Mouse_Down structure.
+ */
+static void _layout_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	Evas_Event_Mouse_Down *ev = (Evas_Event_Mouse_Down *)event_info;
+
+	if (ev && (_is_inside_part(PART_MISSED_CALLS, ev->canvas.x, ev->canvas.y) ||
+			_is_inside_part(PART_UNREAD_MESSAGES, ev->canvas.x, ev->canvas.y)))
+		s_info.touch.event_time = ecore_loop_time_get();
+	else
+		s_info.touch.event_time = 0.0;
+}
+
+/*
+ * @brief Checks whether the point lies within the part's object, i.e. within the icon's hit area.
+ * @param[part_name]: the name of the part.
+ * @param[x]: the horizontal canvas coordinate of the point.
+ * @param[y]: the vertical canvas coordinate of the point.
+ * @return: true if the point is inside the part, otherwise false.
+ */
+static bool _is_inside_part(const char *part_name, Evas_Coord x, Evas_Coord y)
+{
+	Evas_Object *part = _part_object_get(part_name);
+	Evas_Coord px, py, pw, ph;
+
+	if (!part)
+		return false;
+
+	evas_object_geometry_get(part, &px, &py, &pw, &ph);
+
+	return x >= px && x < px + pw && y >= py && y < py + ph;
+}
+
+/*
+ * @brief Records the moment of the touch, i.e. the start of the main loop iteration in which the
+ * mouse down event has been dispatched. The icon's pressed image is switched by the EDJE program
+ * (or by the native scene) itself, so the feedback latency is measured up to the first frame
+ * rendered afterwards.
+ */
+static void _touch_begin(void)
+{
+	energy_begin(ENERGY_SOURCE_TOUCH);
+
+	s_info.touch.down_time = s_info.touch.event_time > 0.0 ? s_info.touch.event_time : ecore_loop_time_get();
+	s_info.touch.event_time = 0.0;
+	s_info.touch.feedback_pending = true;
+
+	_render_expect(ENERGY_SOURCE_TOUCH);
+
+	energy_end();
+}
+
+/*
+ * @brief Invokes the icon pressed callback and measures the time from the touch release
+ * until the callback has returned, i.e. until the launch request has been sent.
+ * @param[id]: the identifier of the released icon.
+ */
+static void _touch_end(view_icon_id_t id)
+{
+	energy_begin(ENERGY_SOURCE_TOUCH);
+
+	s_info.touch.up_time = ecore_time_get();
+
+	if (s_info.icon_pressed_cb) {
+		s_info.icon_pressed_cb(id);
+
+		_latency_stats_add(&s_info.touch.launch, ecore_time_get() - s_info.touch.up_time);
+
+		if (s_info.touch.launch.count % TOUCH_STATS_REPORT_TAPS == 0)
+			_touch_stats_report();
+	}
+
+	energy_end();
+}
+
+/*
+ * @brief Adds the latency sample to the statistics.
+ * @param[stats]: the statistics to be updated.
+ * @param[latency]: the latency in seconds.
+ */
+static void _latency_stats_add(struct _latency_stats *stats, double latency)
+{
+	if (stats->count == 0 || latency < stats->min)
+		stats->min = latency;
+
+	if (stats->count == 0 || latency > stats->max)
+		stats->max = latency;
+
+	stats->sum += latency;
+	stats->count++;
+}
+
+/*
+ * @brief Logs the touch-to-feedback and touch-to-launch-request latencies in milliseconds.
+ */
+static void _touch_stats_report(void)
+{
+	struct _latency_stats *feedback = &s_info.touch.feedback;
+	struct _latency_stats *launch = &s_info.touch.launch;
+
+	if (feedback->count > 0)
+		dlog_print(DLOG_DEBUG, LOG_TAG, "touch-to-feedback: %d taps, min %.2f ms, avg %.2f ms, max %.2f ms",
+				feedback->count, feedback->min * 1000.0, feedback->sum * 1000.0 / feedback->count, feedback->max * 1000.0);
+
+	if (launch->count > 0)
+		dlog_print(DLOG_DEBUG, LOG_TAG, "touch-to-launch-request: %d taps, min %.2f ms, avg %.2f ms, max %.2f ms",
+				launch->count, launch->min * 1000.0, launch->sum * 1000.0 / launch->count, launch->max * 1000.0);
+}
+
+/*
+ * @brief Attributes the next frame rendered to the event of the given source.
+ * @param[source]: the source of the event which has changed the frame.
+ */
+static void _render_expect(energy_source_t source)
+{
+	s_info.render.pending = true;
+	s_info.render.source = source;
+}
+
+/*
+ * @brief The callback function invoked before each frame is rendered to the canvas.
+ * @param[data]: the user data passed to the evas_event_callback_add function.
+ * @param[e]: the canvas which is about to be rendered.
+ * @param[event_info]: not used.
+ */
+static void _render_pre_cb(void *data, Evas *e, void *event_info)
+{
+	s_info.render.start = ecore_time_get();
+}
+
+/*
+ * @brief The callback function invoked after each frame is rendered to the canvas. The rendering is
+ * attributed to the event which has changed the frame or, if no change is pending, to the last event.
+ * @param[data]: the user data passed to the evas_event_callback_add function.
+ * @param[e]: the canvas which has been rendered.
+ * @param[event_info]: the Evas_Event_Render_Post structure with the updated areas, if provided.
+ */
+static void _render_post_cb(void *data, Evas *e, void *event_info)
+{
+	Evas_Event_Render_Post *post = (Evas_Event_Render_Post *)event_info;
+	unsigned long long pixels = 0;
+	Eina_Rectangle *rect = NULL;
+	Eina_List *l = NULL;
+	double now = ecore_time_get();
+	energy_source_t source = s_info.render.pending ? s_info.render.source : energy_get_source();
+
+	s_info.render.pending = false;
+
+	/*
+	 * The glyphs which are no longer displayed are released once the frame without them is rendered.
+	 */
+	if (s_info.font_cache_flush) {
+		s_info.font_cache_flush = false;
+		evas_font_cache_flush(e);
+	}
+
+	if (!s_info.startup.first_frame) {
+		s_info.startup.first_frame = true;
+		_account_decoded_images(source);
+
+		dlog_print(DLOG_INFO, LOG_TAG, "startup (%s): view created in %.2f ms, first frame in %.2f ms",
+				s_info.scene ? "native scene" : "edje",
+				(s_info.startup.view_created - s_info.startup.start) * 1000.0, (now - s_info.startup.start) * 1000.0);
+	}
+
+	if (s_info.stats.flush_time > 0.0) {
+		s_info.stats.frame_time_sum += now - s_info.stats.flush_time;
+		s_info.stats.frames++;
+		s_info.stats.total_frame_time_sum += now - s_info.stats.flush_time;
+		s_info.stats.total_frames++;
+		s_info.stats.flush_time = 0.0;
+	}
+
+	if (post) {
+		EINA_LIST_FOREACH(post->updated_area, l, rect)
+			pixels += (unsigned long long)rect->w * rect->h;
+	} else {
+		pixels = (unsigned long long)s_info.w * s_info.h;
+	}
+
+	energy_account_busy(source, s_info.render.start > 0.0 ? now - s_info.render.start : 0.0);
+	energy_account_pixels(source, pixels);
+
+	if (!s_info.touch.feedback_pending)
+		return;
+
+	s_info.touch.feedback_pending = false;
+
+	_latency_stats_add(&s_info.touch.feedback, now - s_info.touch.down_time);
+}
+
+/*
+ * @brief Gets the size of the image data decoded by this instance for the given image parts of the view.
+ * The images mapped from the asset store are not included.
+ * @param[parts]: the names of the image parts.
+ * @param[count]: the number of the parts.
+ * @return: The total size in bytes of the ARGB8888 image data.
+ */
+static unsigned long long _get_decoded_parts_size(const char **parts, int count)
+{
+	unsigned long long size = 0;
+	int w, h;
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (s_info.scene && scene_part_is_shared(parts[i]))
+			continue;
+
+		w = h = 0;
+		evas_object_image_size_get(_part_object_get(parts[i]), &w, &h);
+		size += (unsigned long long)w * h * 4;
+	}
+
+	return size;
+}
+
+/*
+ * @brief Accounts the images decoded for the first frame to the energy and memory statistics.
+ * The images shared through the asset store are accounted in proportion to the number of
+ * the instances sharing them.
+ * @param[source]: the source of the event whose frame has decoded the images.
+ */
+static void _account_decoded_images(energy_source_t source)
+{
+	static const char *image_parts[] = {
+		PART_BACKGROUND, PART_MISSED_CALLS, PART_UNREAD_MESSAGES,
+		PART_HANDS_CENTER, PART_HAND_HOUR, PART_HAND_MINUTE, PART_HAND_SECOND,
+	};
+	static const char *badge_parts[] = {
+		PART_MISSED_CALLS_BADGE, PART_UNREAD_MESSAGES_BADGE,
+	};
+	unsigned long long images_size = _get_decoded_parts_size(image_parts, sizeof(image_parts) / sizeof(image_parts[0]));
+	unsigned long long badges_size = _get_decoded_parts_size(badge_parts, sizeof(badge_parts) / sizeof(badge_parts[0]));
+
+	energy_account_decoded(source, images_size + badges_size);
+
+	s_info.images_size = (size_t)images_size;
+	_account_images();
+
+	if (!memory_set_usage(MEMORY_SUBSYSTEM_BADGES, (size_t)badges_size))
+		_memory_exceeded();
+}
+
+/*
+ * @brief Accounts the images decoded by this instance and its share of the asset store to the images.
+ * The share changes whenever another instance attaches to the store or detaches from it, so it is
+ * refreshed on each frame state flush as well.
+ */
+static void _account_images(void)
+{
+	size_t size = s_info.images_size + asset_store_get_proportional_size();
+
+	if (size == memory_get_current(MEMORY_SUBSYSTEM_IMAGES))
+		return;
+
+	if (!memory_set_usage(MEMORY_SUBSYSTEM_IMAGES, size))
+		_memory_exceeded();
+}
+
+/*
+ * @brief Adds the characters of the value, as displayed by the view, to the set of the glyphs.
+ * @param[glyphs]: the set of the glyphs: a bit per digit and the GLYPH_PLUS bit.
+ * @param[value]: the value. Values which are not positive are not displayed.
+ * @param[capped]: 'true' if the values above BADGE_MAX_VALUE are displayed as '99+'.
+ * @return: The set of the glyphs with the characters of the value added.
+ */
+static unsigned int _glyphs_add(unsigned int glyphs, int value, bool capped)
+{
+	if (value <= 0)
+		return glyphs;
+
+	if (capped && value > BADGE_MAX_VALUE) {
+		glyphs |= GLYPH_PLUS;
+		value = BADGE_MAX_VALUE;
+	}
+
+	do {
+		glyphs |= 1u << (value % 10);
+		value /= 10;
+	} while (value > 0);
+
+	return glyphs;
+}
+
+/*
+ * @brief Accounts the glyphs of the badge counters and the complication values displayed to the text.
+ * Each distinct character is rasterised once per font size, so the usage follows the displayed values
+ * rather than the font cache cap.
+ */
+static void _account_text(void)
+{
+	unsigned int badge_glyphs = _glyphs_add(_glyphs_add(0, s_info.frame.missed_calls, true), s_info.frame.unread_messages, true);
+	unsigned int complication_glyphs = _glyphs_add(_glyphs_add(0, s_info.frame.steps, false), s_info.frame.heart_rate, false);
+	int badge_font_size = (int)(BADGE_FONT_SIZE * elm_config_scale_get() + 0.5);
+	int complication_font_size = (int)(COMPLICATION_FONT_SIZE * elm_config_scale_get() + 0.5);
+	size_t size = __builtin_popcount(badge_glyphs) * MEMORY_GLYPH_BYTES(badge_font_size) +
+			__builtin_popcount(complication_glyphs) * MEMORY_GLYPH_BYTES(complication_font_size);
+
+	if (size < memory_get_current(MEMORY_SUBSYSTEM_TEXT))
+		s_info.font_cache_flush = true;
+
+	if (!memory_set_usage(MEMORY_SUBSYSTEM_TEXT, size))
+		_memory_exceeded();
+}
+
+/*
+ * @brief Frees the decoded images and glyphs kept by the canvas for later use, as the memory in use
+ * does not fit into the budget even though the optional assets have been evicted.
+ */
+static void _memory_exceeded(void)
+{
+	Evas *evas = evas_object_evas_get(s_info.win);
+
+	evas_image_cache_set(evas, 0);
+	evas_font_cache_set(evas, 0);
 
-	edje_object_message_send(elm_layout_edje_get(s_info.layout), EDJE_MESSAGE_INT, message_id, &msg);
+	memory_report();
 }
 
+#if defined(VIEW_TAP_BENCHMARK)
+/*
+ * @brief The timer callback which simulates rapid tapping by feeding alternate mouse down
+ * and mouse up events to the centre of the 'missed calls' and 'unread messages' icons.
+ * @param[data]: not used.
+ * @return: ECORE_CALLBACK_RENEW until TAP_BENCHMARK_TAPS taps are simulated.
+ */
+static Eina_Bool _tap_benchmark_cb(void *data)
+{
+	view_icon_id_t id;
+
+	if (s_info.benchmark_events >= 2 * TAP_BENCHMARK_TAPS) {
+		dlog_print(DLOG_INFO, LOG_TAG, "tap benchmark finished.");
+		_touch_stats_report();
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	id = (s_info.benchmark_events / 2) % 2 ? VIEW_ICON_ID_UNREAD_MESSAGES : VIEW_ICON_ID_MISSED_CALLS;
+
+	view_feed_icon_event(id, s_info.benchmark_events % 2 == 0);
+
+	s_info.benchmark_events++;
+
+	return ECORE_CALLBACK_RENEW;
+}
+#endif
+
+#if defined(VIEW_FRAME_BENCHMARK)
+/*
+ * @brief The timer callback which drives a mixed load through the frame state setters: a time tick
+ * in every iteration, a 'missed calls' change in every 2nd one, an 'unread messages' change in every
+ * 3rd one and a burst in which both counters change twice in every 10th one. Once finished, the total
+ * numbers of the frame state changes, the messages sent and the layout recalculations are logged along
+ * with the average time from the flush to the render, so the native scene and EDJE builds can be compared.
+ * @param[data]: not used.
+ * @return: ECORE_CALLBACK_RENEW until FRAME_BENCHMARK_ITERATIONS iterations are driven.
+ */
+static Eina_Bool _frame_benchmark_cb(void *data)
+{
+	int i = s_info.benchmark_iterations;
+	current_time_t current_time = {10, i / 60 % 60, i % 60};
+
+	if (i >= FRAME_BENCHMARK_ITERATIONS) {
+#if defined(VIEW_FRAME_STATE_UNBATCHED)
+		dlog_print(DLOG_INFO, LOG_TAG, "frame benchmark (unbatched, %s): %d iterations, %d changes, %d messages, %d recalcs, %.2f ms from flush to render",
+#else
+		dlog_print(DLOG_INFO, LOG_TAG, "frame benchmark (batched, %s): %d iterations, %d changes, %d messages, %d recalcs, %.2f ms from flush to render",
+#endif
+				s_info.scene ? "native scene" : "edje", i, s_info.stats.total_changes, s_info.stats.total_messages, s_info.stats.total_recalcs,
+				s_info.stats.total_frames > 0 ? s_info.stats.total_frame_time_sum * 1000.0 / s_info.stats.total_frames : 0.0);
+		return ECORE_CALLBACK_CANCEL;
+	}
+
+	view_set_display_time(current_time);
+
+	if (i % 2 == 0)
+		view_set_bagde_missed_calls(i % 100);
+
+	if (i % 3 == 0)
+		view_set_bagde_unread_messages(i % 100);
+
+	if (i % 10 == 0) {
+		view_set_bagde_missed_calls(0);
+		view_set_bagde_unread_messages(0);
+	}
+
+	s_info.benchmark_iterations++;
+
+	return ECORE_CALLBACK_RENEW;
+}
+#endif
+
 /*
  * @brief The callback function invoked on mouse down event over the 'missed calls' icon.
  * @param[data]: the user data passed to the elm_object_signal_callback_add function.
@@ -294,7 +1113,7 @@ static void _set_badge(int message_id, int badge_count)
  */
 static void _missed_calls_mouse_down_cb(void *data, Evas_Object *obj, const char *emission, const char *source)
 {
-	_emit_signal(obj, PART_MISSED_CALLS, SIGNAL_MISSED_CALLS_PRESS);
+	_touch_begin();
 }
 
 /*
@@ -306,10 +1125,7 @@ static void _missed_calls_mouse_down_cb(void *data, Evas_Object *obj, const char
  */
 static void _missed_calls_mouse_up_cb(void *data, Evas_Object *obj, const char *emission, const char *source)
 {
-	_emit_signal(obj, PART_MISSED_CALLS, SIGNAL_MISSED_CALLS_UNPRESS);
-
-	if (s_info.icon_pressed_cb)
-		s_info.icon_pressed_cb(VIEW_ICON_ID_MISSED_CALLS);
+	_touch_end(VIEW_ICON_ID_MISSED_CALLS);
 }
 
 /*
@@ -321,7 +1137,7 @@ static void _missed_calls_mouse_up_cb(void *data, Evas_Object *obj, const char *
  */
 static void _unread_messages_mouse_down_cb(void *data, Evas_Object *obj, const char *emission, const char *source)
 {
-	_emit_signal(obj, PART_UNREAD_MESSAGES, SIGNAL_UNREAD_MESSAGES_PRESS);
+	_touch_begin();
 }
 
 /*
@@ -333,8 +1149,33 @@ static void _unread_messages_mouse_down_cb(void *data, Evas_Object *obj, const c
  */
 static void _unread_messages_mouse_up_cb(void *data, Evas_Object *obj, const char *emission, const char *source)
 {
-	_emit_signal(obj, PART_UNREAD_MESSAGES, SIGNAL_UNREAD_MESSAGES_UNPRESS);
+	_touch_end(VIEW_ICON_ID_UNREAD_MESSAGES);
+}
+
+#if defined(VIEW_NATIVE_SCENE)
+/*
+ * @brief The callback function invoked on mouse down event over the icon of the native scene.
+ * @param[data]: not used.
+ * @param[e]: the canvas.
+ * @param[obj]: the icon's image object.
+ * @param[event_info]: the Evas_Event_Mouse_Down structure.
+ */
+static void _icon_mouse_down_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	s_info.touch.event_time = ecore_loop_time_get();
 
-	if (s_info.icon_pressed_cb)
-		s_info.icon_pressed_cb(VIEW_ICON_ID_UNREAD_MESSAGES);
+	_touch_begin();
+}
+
+/*
+ * @brief The callback function invoked on mouse up event over the icon of the native scene.
+ * @param[data]: the identifier of the icon.
+ * @param[e]: the canvas.
+ * @param[obj]: the icon's image object.
+ * @param[event_info]: the Evas_Event_Mouse_Up structure.
+ */
+static void _icon_mouse_up_cb(void *data, Evas *e, Evas_Object *obj, void *event_info)
+{
+	_touch_end((view_icon_id_t)(intptr_t)data);
 }
+#endif
@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+#
+# Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+
+"""
+Generates the native scene description (see inc/scene.h) of the 'main' group of main.edc.
+
+The part tree is resolved into absolute geometry for each target resolution, so the
+watch face can be drawn without loading main.edj and running its Embryo script.
+Only the subset of EDC used by main.edc is supported: IMAGE, RECT and TEXTBLOCK parts,
+rel1/rel2 'relative' and 'to', map rotation centres, the pressed image state and the
+set_badge()/set_complication() calls of the script.
+
+Usage: edc2scene.py <main.edc> <output.c>
+"""
+
+import os
+import re
+import sys
+
+GROUP_NAME = "main"
+RESOLUTIONS = [(360, 360), (320, 320)]
+STATE_PRESSED_DEFINE = "STATE_IMAGE_PRESSED"
+BADGE_MAX_VALUE = 99
+
+PART_TYPES = {
+    "IMAGE": "SCENE_PART_IMAGE",
+    "RECT": "SCENE_PART_RECT",
+    "TEXTBLOCK": "SCENE_PART_TEXTBLOCK",
+}
+
+
+class Block(object):
+    def __init__(self, name):
+        self.name = name
+        self.props = []
+        self.children = []
+
+    def prop(self, key, default=None):
+        for k, v in self.props:
+            if k == key:
+                return v
+        return default
+
+    def child(self, name):
+        for c in self.children:
+            if c.name == name:
+                return c
+        return None
+
+    def all(self, name):
+        return [c for c in self.children if c.name == name]
+
+
+def read_defines(path, defines):
+    base_dir = os.path.dirname(path)
+    lines = []
+    with open(path) as f:
+        for line in f:
+            m = re.match(r'\s*#include\s+"([^"]+)"', line)
+            if m:
+                read_defines(os.path.normpath(os.path.join(base_dir, m.group(1))), defines)
+                continue
+            m = re.match(r'\s*#define\s+(\w+)\s+(.+?)\s*$', line)
+            if m:
+                defines[m.group(1)] = m.group(2)
+                continue
+            if line.lstrip().startswith("#"):
+                continue
+            lines.append(line)
+    return "".join(lines)
+
+
+def strip_comments(text):
+    text = re.sub(r"/\*.*?\*/", "", text, flags=re.S)
+    return re.sub(r"//[^\n]*", "", text)
+
+
+def tokenize(text, defines):
+    tokens = re.findall(r'"[^"]*"|[{};:]|[^\s{};:"]+', text)
+    result = []
+    for t in tokens:
+        depth = 0
+        while t in defines and depth < 16:
+            t = defines[t]
+            depth += 1
+        result.append(t)
+    return result
+
+
+def parse(tokens):
+    root = Block(None)
+    stack = [root]
+    pending = []
+    i = 0
+    while i < len(tokens):
+        t = tokens[i]
+        if t == "{":
+            name = pending[-1] if pending else None
+            block = Block(name)
+            stack[-1].children.append(block)
+            stack.append(block)
+            pending = []
+            if name == "script":
+                i = skip_block(tokens, i)
+                stack.pop()
+                continue
+        elif t == "}":
+            stack.pop()
+            pending = []
+        elif t == ":":
+            key = pending[-1]
+            values = []
+            i += 1
+            while tokens[i] not in (";", "}"):
+                values.append(tokens[i])
+                i += 1
+            stack[-1].props.append((key, values))
+            pending = []
+            if tokens[i] == "}":
+                continue
+        elif t == ";":
+            pending = []
+        else:
+            pending.append(t)
+        i += 1
+    return root
+
+
+def skip_block(tokens, i):
+    depth = 0
+    while i < len(tokens):
+        if tokens[i] == "{":
+            depth += 1
+        elif tokens[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i + 1
+        i += 1
+    raise SystemExit("unterminated block")
+
+
+def unquote(value):
+    return "".join(v.strip('"') for v in value)
+
+
+def description(part, state):
+    for d in part.all("description"):
+        if unquote(d.prop("state", ['"default"'])[:1]) == state:
+            return d
+    return None
+
+
+def rel(desc, name, default):
+    block = desc.child(name) if desc else None
+    if not block:
+        return default, None
+    relative = block.prop("relative")
+    to = block.prop("to")
+    rx, ry = (float(relative[0]), float(relative[1])) if relative else default
+    return (rx, ry), (unquote(to) if to else None)
+
+
+def image_path(edc_path):
+    return "images/" + os.path.basename(edc_path)
+
+
+def collect_parts(group, styles, defines):
+    pressed_state = unquote([defines.get(STATE_PRESSED_DEFINE, STATE_PRESSED_DEFINE)])
+    parts = []
+    for p in group.child("parts").all("part"):
+        name = unquote(p.prop("name"))
+        desc = description(p, "default")
+        rel1, to1 = rel(desc, "rel1", (0.0, 0.0))
+        rel2, to2 = rel(desc, "rel2", (1.0, 1.0))
+        image = desc.child("image") if desc else None
+        text = desc.child("text") if desc else None
+        map_block = desc.child("map") if desc else None
+        rotation = map_block.child("rotation") if map_block else None
+        pressed = description(p, pressed_state)
+        pressed_image = pressed.child("image") if pressed else None
+        color = desc.prop("color") if desc else None
+        visible = desc.prop("visible", ["1"]) if desc else ["1"]
+        parts.append({
+            "name": name,
+            "type": unquote(p.prop("type")),
+            "rel1": rel1, "to1": to1,
+            "rel2": rel2, "to2": to2,
+            "image": image_path(unquote(image.prop("normal"))) if image else None,
+            "pressed_image": image_path(unquote(pressed_image.prop("normal"))) if pressed_image else None,
+            "visible": int(visible[0]) != 0,
+            "mouse_events": int(unquote(p.prop("mouse_events", ["1"]))) != 0,
+            "repeat_events": int(unquote(p.prop("repeat_events", ["0"]))) != 0,
+            "rotation_center": unquote(rotation.prop("center")) if rotation else None,
+            "color": [int(c) for c in color] if color else [255, 255, 255, 255],
+            "text_style": styles.get(unquote(text.prop("style"))) if text else None,
+        })
+    return parts
+
+
+def collect_styles(root):
+    styles = {}
+    for block in root.all("styles"):
+        for s in block.all("style"):
+            styles[unquote(s.prop("name"))] = unquote(s.prop("base"))
+    return styles
+
+
+def geometry(parts, width, height):
+    index = dict((p["name"], p) for p in parts)
+    cache = {}
+
+    def rect(name):
+        if name is None:
+            return (0, 0, width, height)
+        if name in cache:
+            return cache[name]
+        p = index[name]
+        x0, y0, w0, h0 = rect(p["to1"])
+        x1, y1, w1, h1 = rect(p["to2"])
+        left = int(x0 + p["rel1"][0] * w0)
+        top = int(y0 + p["rel1"][1] * h0)
+        right = int(x1 + p["rel2"][0] * w1)
+        bottom = int(y1 + p["rel2"][1] * h1)
+        cache[name] = (left, top, max(right - left, 0), max(bottom - top, 0))
+        return cache[name]
+
+    result = []
+    for p in parts:
+        x, y, w, h = rect(p["name"])
+        cx, cy = 0, 0
+        if p["rotation_center"]:
+            rx, ry, rw, rh = rect(p["rotation_center"])
+            cx, cy = rx + rw // 2, ry + rh // 2
+        result.append((x, y, w, h, cx, cy))
+    return result
+
+
+def collect_counters(script, defines, parts):
+    names = [p["name"] for p in parts]
+    counters = []
+
+    def idx(token):
+        return names.index(unquote([defines.get(token, token)]))
+
+    for m in re.finditer(r"set_badge\(\s*get_part_id\((\w+)\),\s*get_part_id\((\w+)\),\s*getarg\(2 \+ (\w+)\)\)", script):
+        counters.append((idx(m.group(1)), idx(m.group(2)), m.group(3), BADGE_MAX_VALUE))
+
+    for m in re.finditer(r"set_complication\(PART:(\w+),\s*getarg\(2 \+ (\w+)\)\)", script):
+        counters.append((-1, idx(m.group(1)), m.group(2), 0))
+
+    return counters
+
+
+def c_string(value):
+    if value is None:
+        return "NULL"
+    return '"%s"' % value.replace("\\", "\\\\").replace('"', '\\"')
+
+
+def emit(out, edc_path, parts, counters):
+    w = out.write
+    w("/*\n * Generated by tools/edc2scene.py from %s. Do not edit.\n */\n\n" % os.path.basename(edc_path))
+    w('#include "scene.h"\n#include "view_defines.h"\n\n')
+
+    for width, height in RESOLUTIONS:
+        w("static const scene_part_t s_parts_%dx%d[] = {\n" % (width, height))
+        for p, (x, y, pw, ph, cx, cy) in zip(parts, geometry(parts, width, height)):
+            w("\t{\n")
+            w("\t\t.name = %s,\n" % c_string(p["name"]))
+            w("\t\t.type = %s,\n" % PART_TYPES[p["type"]])
+            w("\t\t.x = %d, .y = %d, .w = %d, .h = %d,\n" % (x, y, pw, ph))
+            w("\t\t.image = %s,\n" % c_string(p["image"]))
+            w("\t\t.pressed_image = %s,\n" % c_string(p["pressed_image"]))
+            w("\t\t.color = {%s},\n" % ", ".join(str(c) for c in p["color"]))
+            w("\t\t.text_style = %s,\n" % c_string(p["text_style"]))
+            w("\t\t.visible = %s,\n" % ("true" if p["visible"] else "false"))
+            w("\t\t.mouse_events = %s,\n" % ("true" if p["mouse_events"] else "false"))
+            w("\t\t.repeat_events = %s,\n" % ("true" if p["repeat_events"] else "false"))
+            w("\t\t.map_rotation = %s,\n" % ("true" if p["rotation_center"] else "false"))
+            w("\t\t.center_x = %d, .center_y = %d,\n" % (cx, cy))
+            w("\t},\n")
+        w("};\n\n")
+
+    w("static const scene_counter_t s_counters[] = {\n")
+    for badge, text, index, max_value in counters:
+        dirty_flag = index.replace("FRAME_STATE_IDX_", "FRAME_STATE_DIRTY_")
+        w("\t{.badge_part = %d, .text_part = %d, .frame_state_idx = %s, .dirty_flag = %s, .max_value = %d},\n"
+          % (badge, text, index, dirty_flag, max_value))
+    w("};\n\n")
+
+    w("const scene_t scene_main[] = {\n")
+    for width, height in RESOLUTIONS:
+        w("\t{\n")
+        w("\t\t.width = %d,\n\t\t.height = %d,\n" % (width, height))
+        w("\t\t.parts = s_parts_%dx%d,\n" % (width, height))
+        w("\t\t.part_count = sizeof(s_parts_%dx%d) / sizeof(s_parts_%dx%d[0]),\n" % (width, height, width, height))
+        w("\t\t.counters = s_counters,\n")
+        w("\t\t.counter_count = sizeof(s_counters) / sizeof(s_counters[0]),\n")
+        w("\t},\n")
+    w("};\n\n")
+    w("const int scene_main_count = sizeof(scene_main) / sizeof(scene_main[0]);\n")
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write(__doc__)
+        return 1
+
+    edc_path, out_path = argv[1], argv[2]
+    defines = {}
+    text = strip_comments(read_defines(edc_path, defines))
+    script = re.search(r"\bscript\s*{(.*)", text, flags=re.S).group(1)
+    root = parse(tokenize(text, defines))
+
+    collections = root.child("collections")
+    group = [g for g in collections.all("group") if unquote(g.prop("name")) == GROUP_NAME][0]
+    parts = collect_parts(group, collect_styles(root), defines)
+    counters = collect_counters(script, defines, parts)
+
+    # The output is replaced only if its content changes, so the checked-in file is not modified
+    # by the builds which do not change the scene. Its modification time is still updated, so make
+    # does not run the generator again until main.edc changes.
+    tmp_path = out_path + ".tmp"
+    with open(tmp_path, "w") as out:
+        emit(out, edc_path, parts, counters)
+
+    if read_file(out_path) == read_file(tmp_path):
+        os.remove(tmp_path)
+        os.utime(out_path, None)
+    else:
+        replace_file(tmp_path, out_path)
+
+    return 0
+
+
+def read_file(path):
+    if not os.path.exists(path):
+        return None
+    with open(path, "rb") as f:
+        return f.read()
+
+
+def replace_file(src, dst):
+    if hasattr(os, "replace"):
+        os.replace(src, dst)
+    else:
+        # Python 2 on Windows cannot rename over an existing file.
+        if os.path.exists(dst):
+            os.remove(dst)
+        os.rename(src, dst)
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,34 @@
+#!/bin/sh
+#
+# Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Sums the proportional set size of all the running instances of the face (e.g. the watch face
+# picker's preview and the live face), so the memory saved by the shared asset store can be compared
+# with a build made with ASSET_STORE_ENABLED=0.
+#
+# Usage: pss_total.sh [process name]
+# Runs on the host, the device or the emulator must be connected with sdb.
+#
+
+NAME=${1:-analogwatch}
+
+# The processes are matched by their exact name in /proc/<pid>/comm, which the kernel truncates to
+# 15 characters, so neither the shell running the loop nor any other command mentioning the name
+# is counted. The shell's own pid is skipped as well.
+COMM=$(printf '%.15s' "$NAME")
+
+sdb shell "self=\$\$; for dir in /proc/[0-9]*; do pid=\${dir#/proc/}; [ \$pid = \$self ] && continue; [ \"\$(cat \$dir/comm 2>/dev/null)\" = '$COMM' ] || continue; awk -v pid=\$pid '/^Pss:/ { kb += \$2 } END { printf \"%s %d kB\\n\", pid, kb }' \$dir/smaps; done" |
+	tr -d '\r' |
+	awk '{ print "pid " $1 ": PSS " $2 " kB"; total += $2 } END { printf "total PSS %d kB, %d instances\n", total, NR }'
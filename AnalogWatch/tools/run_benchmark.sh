@@ -0,0 +1,72 @@
+#!/bin/sh
+#
+# Copyright (c) 2016 Samsung Electronics Co., Ltd. All rights reserved.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+# http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+#
+# Runs a benchmark build of the face (built with MEMORY_BENCHMARK or ENERGY_BENCHMARK in USER_DEFS)
+# unattended: installs the package, launches the face, waits until the benchmark logs its verdict
+# and exits with it, so the budgets can be checked on every build without reading the log.
+# The 'frame' mode runs a VIEW_FRAME_BENCHMARK build and prints its startup and frame cost, so
+# the builds with and without VIEW_NATIVE_SCENE can be compared.
+#
+# Usage: run_benchmark.sh <package.tpk> memory|energy|frame [timeout in seconds]
+# Runs on the host, the device or the emulator must be connected with sdb.
+# Exits with 0 if the budget is met (or the frame benchmark has finished), 1 if it is exceeded
+# and 2 if no verdict is logged in time.
+#
+
+TPK=$1
+BENCHMARK=$2
+TIMEOUT=${3:-600}
+APPID=org.example.analogwatch2
+LOG_TAG=analogwatch
+
+case "$BENCHMARK" in
+memory|energy)
+	VERDICT="$BENCHMARK budget (met|exceeded):"
+	REPORT="(memory|energy)[: ]"
+	;;
+frame)
+	VERDICT="frame benchmark \("
+	REPORT="startup \(|frame benchmark \("
+	;;
+*)
+	BENCHMARK=
+	;;
+esac
+
+if [ ! -f "$TPK" ] || [ -z "$BENCHMARK" ]; then
+	echo "usage: $0 <package.tpk> memory|energy|frame [timeout in seconds]" >&2
+	exit 2
+fi
+
+sdb install "$TPK" || exit 2
+sdb dlog -c
+sdb shell "app_launcher -s $APPID" || exit 2
+
+elapsed=0
+while [ $elapsed -lt "$TIMEOUT" ]; do
+	verdict=$(sdb dlog -d -v brief "$LOG_TAG:I" "*:S" | tr -d '\r' | grep -E "$VERDICT")
+	if [ -n "$verdict" ]; then
+		sdb dlog -d -v brief "$LOG_TAG:I" "*:S" | tr -d '\r' | grep -E "$REPORT"
+		echo "$verdict" | grep -q "budget exceeded:" && exit 1
+		exit 0
+	fi
+
+	sleep 5
+	elapsed=$((elapsed + 5))
+done
+
+echo "no $BENCHMARK benchmark verdict within $TIMEOUT s" >&2
+exit 2